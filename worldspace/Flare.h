@@ -5,13 +5,13 @@
 struct Flare {
 protected:
 	unsigned short
-		_time,			// How many frames to display the flare for
+		_time,			// How many ticks to display the flare for
 		_color;			// which color to use for flare
 
 	/**
 	 * Flare(Coord&, unsigned short, unsigned short)
 	 * @brief Construct a flare instance
-	 * @param flareTime	 - How many frames total to flare the display. Should be a multiple of 2.
+	 * @param flareTime	 - How many ticks total to flare the display. Should be a multiple of 2.
 	 * @param flareColor - Which color to use, this should be a windows API color.
 	 */
 	Flare(const unsigned short flareTime, const unsigned short flareColor) : _time(flareTime), _color(static_cast<unsigned short>(flareColor)), _max_time(_time) {}
@@ -80,14 +80,14 @@ struct FlareLevel final : Flare {
 
 	/**
 	 * FlareLevel()
-	 * @brief Default constructor with preset color of BACKGROUND_GREEN, and a time of 6 frames.
+	 * @brief Default constructor with preset color of BACKGROUND_GREEN, and a time of 6 ticks.
 	 */
 	FlareLevel() : Flare(6, Color::_b_green) {}
 
 	/**
 	 * FlareLevel(unsigned short, Color)
 	 * @brief Constructor with defined time & color values.
-	 * @param flareTime  - The amount of frames to show a flare.
+	 * @param flareTime  - The amount of ticks to show a flare.
 	 * @param flareColor - The color to flare.
 	 */
 	FlareLevel(const unsigned short flareTime, const unsigned short flareColor) : Flare(flareTime, flareColor) {}
@@ -116,14 +116,14 @@ public:
 	 * @brief Constructor with defined time & color values.
 	 *
 	 * @param cellSize	 - A ref to the cell's _max member, representing the size of the tile matrix.
-	 * @param flareTime  - The amount of frames to show a flare.
+	 * @param flareTime  - The amount of ticks to show a flare.
 	 * @param flareColor - The color to flare.
 	 */
 	FlareChallenge(const Coord& cellSize, const unsigned short flareTime, const unsigned short flareColor) : Flare(flareTime, flareColor), _cell_size(cellSize._x - 1, cellSize._y - 1) {}
 
 	/**
 	 * FlareChallenge(Coord&)
-	 * @brief Default constructor. Uses BACKGROUND_RED & time of 10 frames.
+	 * @brief Default constructor. Uses BACKGROUND_RED & time of 10 ticks.
 	 *
 	 * @param cellSize	- A ref to the cell's _max member, representing the size of the tile matrix.
 	 */
@@ -5,92 +5,116 @@
  * Used in FrameBuffer.h
  */
 #pragma once
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 
 #include "Coord.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FRAME_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define FRAME_SIMD_SSE2
+#endif
+
 /**
  * @struct Frame
- * @brief Represents a single frame shown in the console.
+ * @brief Represents a single frame shown in the console, as a flat row-major array of cells. \n
+ * Each cell packs a character & its color into a single 32-bit value, so two frames can be compared a whole row at a time with SIMD instructions. \n
  * Used for output buffering to only change characters that have been modified between frames.
  */
 struct Frame {
-	// This frame's buffer
-	std::vector<std::vector<char> > _frame;
-	Coord _origin;
-	bool _space_columns;
+	using Cell = std::uint32_t; ///< @brief A packed cell, the character is stored in the low byte & the color attribute in the high 16 bits.
+	static constexpr Cell INVALID{ 0xFFFFFFFFu }; ///< @brief A cell value that never matches a real cell, used to force every cell to be redrawn.
+
+	std::vector<Cell> _cells;	///< @brief This frame's cells, in row-major order.
+	Coord _size;				///< @brief The number of columns & rows in this frame.
 
 	/** CONSTRUCTOR
 	 * Frame()
-	 * @brief Instantiate a blank frame.
+	 * @brief Instantiate an empty frame.
 	 */
-	Frame() : _origin( { 0, 0 } ), _space_columns( false )
-	{
-	}
+	Frame() : _size( 0, 0 ) {}
 
 	/** CONSTRUCTOR
-	 * Frame(vector<vector<char>>)
-	 * @brief Instantiate a pre-made frame
+	 * Frame(Coord&)
+	 * @brief Instantiate a frame of the given size, where every cell is invalid.
+	 * @param size	- The number of columns & rows.
 	 */
-	explicit Frame( std::vector<std::vector<char> > frameMatrix, const Coord& frameOrigin = Coord( 0, 0 ), const bool formatWithSpaces = true ) : _frame( std::move( frameMatrix ) ), _origin( frameOrigin ), _space_columns( formatWithSpaces )
-	{
-	}
+	explicit Frame( const Coord& size ) : _cells( static_cast<size_t>(( size._x > 0 ? size._x : 0 ) * ( size._y > 0 ? size._y : 0 )), INVALID ), _size( size._x > 0 ? size._x : 0, size._y > 0 ? size._y : 0 ) {}
 
 	/**
-	 * isValidSize()
-	 * @brief Check if all rows in this frame are the same size.
-	 * @returns bool	- ( true = frame is valid ) ( false = frame is invalid, row size is variable. )
+	 * pack(char, unsigned short)
+	 * @brief Returns the cell value of a character drawn with a given color.
+	 * @param ch		- The character
+	 * @param color		- The color attribute
+	 * @returns Cell
 	 */
-	bool isValidSize()
-	{
-		if ( !_frame.empty() ) {
-			const auto expected_row_length{ _frame.at( 0 ).size() };
-			for ( auto& it : _frame )
-				if ( it.size() != expected_row_length )
-					return false;
-			return true;
-		}
-		return false;
-	}
+	[[nodiscard]] static constexpr Cell pack( const char ch, const unsigned short color ) noexcept { return static_cast<Cell>(static_cast<unsigned char>(ch)) | static_cast<Cell>(color) << 16u; }
 
 	/**
-	 * size()
-	 * @brief Returns the size of the frame if it is valid.
-	 * @returns Coord
+	 * glyph(Cell)
+	 * @brief Returns the character of a packed cell.
+	 * @param cell	- A packed cell
+	 * @returns char
 	 */
-	Coord size()
-	{
-		if ( !_frame.empty() && isValidSize() )
-			return { static_cast<long>(_frame.at( 0 ).size()), static_cast<long>(_frame.size()) };
-		return { 0, 0 };
-	}
+	[[nodiscard]] static constexpr char glyph( const Cell cell ) noexcept { return static_cast<char>(cell & 0xFFu); }
 
 	/**
-	 * draw()
-	 * @brief Draws this frame to the console at it's origin point.
+	 * color(Cell)
+	 * @brief Returns the color attribute of a packed cell.
+	 * @param cell	- A packed cell
+	 * @returns unsigned short
 	 */
-	void draw()
-	{
-		// use dual-iterators to iterate both the frame, and console position from the origin offset
-		for ( int consoleY{ _origin._y }, frameY{ 0 }; consoleY < _origin._y + static_cast<int>(_frame.size()); consoleY++, frameY++ ) {
-			for ( int consoleX = _origin._x, frameX{ 0 }; consoleX < _origin._x + static_cast<int>(_frame.at( frameY ).size()); consoleX++, frameX++ ) {
-				sys::cursorPos( consoleX * 2, consoleY );		// set the cursor position
-				printf( "%c", _frame.at( frameY ).at( frameX ) );
-				if ( _space_columns )
-					printf( " " );
-			}
-		}
-	}
+	[[nodiscard]] static constexpr unsigned short color( const Cell cell ) noexcept { return static_cast<unsigned short>(cell >> 16u); }
 
-	// Stream insertion operator
-	friend std::ostream& operator<<( std::ostream& os, const Frame& f )
+	/**
+	 * row(long)
+	 * @brief Returns a pointer to the first cell of a row. Does not check boundaries.
+	 * @param y		- The row index.
+	 * @returns Cell*
+	 */
+	[[nodiscard]] Cell* row( const long y ) noexcept { return _cells.data() + static_cast<size_t>(y) * static_cast<size_t>(_size._x); }
+	[[nodiscard]] const Cell* row( const long y ) const noexcept { return _cells.data() + static_cast<size_t>(y) * static_cast<size_t>(_size._x); }
+
+	/**
+	 * fill(Cell)
+	 * @brief Sets every cell to the same value.
+	 * @param value	- A packed cell
+	 */
+	void fill( const Cell value ) { std::fill( _cells.begin(), _cells.end(), value ); }
+
+	/**
+	 * invalidate()
+	 * @brief Sets every cell to INVALID, so that every cell of the next frame is different from this one.
+	 */
+	void invalidate() { fill( INVALID ); }
+
+	/**
+	 * rowEqual(Cell*, Cell*, size_t)
+	 * @brief Checks if two rows of cells are identical, comparing 8 (AVX2) or 4 (SSE2) cells per instruction when available.
+	 * @param a			- The first cell of a row.
+	 * @param b			- The first cell of the other row.
+	 * @param count		- The number of cells in each row.
+	 * @returns bool
+	 */
+	[[nodiscard]] static bool rowEqual( const Cell* a, const Cell* b, const size_t count ) noexcept
 	{
-		for ( const auto& y : f._frame ) {
-			for ( auto x : y ) {
-				os << x << ' ';
-			}
-			os << std::endl;
-		}
-		return os;
+		size_t i{ 0u };
+	#if defined(FRAME_SIMD_AVX2)
+		for ( ; i + 8u <= count; i += 8u )
+			if ( _mm256_movemask_epi8( _mm256_cmpeq_epi32( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(a + i) ), _mm256_loadu_si256( reinterpret_cast<const __m256i*>(b + i) ) ) ) != -1 )
+				return false;
+	#elif defined(FRAME_SIMD_SSE2)
+		for ( ; i + 4u <= count; i += 4u )
+			if ( _mm_movemask_epi8( _mm_cmpeq_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>(a + i) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(b + i) ) ) ) != 0xFFFF )
+				return false;
+	#endif
+		for ( ; i < count; ++i )
+			if ( a[i] != b[i] )
+				return false;
+		return true;
 	}
 };
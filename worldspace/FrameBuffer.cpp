@@ -5,42 +5,55 @@
  */
 #include "FrameBuffer.h"
 #include <sysapi.h>
+#include <algorithm>
+#include <string>
 #include <utility>
 
 /**
- * rebuildCache()
- * @brief Refreshes the cache from current gamespace data.
+ * scatterEntities()
+ * @brief Writes every actor & static item into the overlay layer at its position, after clearing the entities written during the last frame. \n
+ * When more than one entity is located on a tile, the first one is kept, actors in id order come before items.
  */
-void FrameBuffer::rebuildCache() noexcept
+void FrameBuffer::scatterEntities()
 {
-//	try {
-		const auto size{ _cache.size() };
-		_cache.clear();
-		_cache.reserve( size );
-		for ( auto& it : _game.get_all_actors() )
-			_cache.emplace_back( std::make_tuple( it->pos(), it->getChar(), it->getColor() ) );
-		for ( auto& it : _game.get_all_static_items() )
-			_cache.emplace_back( std::make_tuple( it->pos(), it->getChar(), it->getColor() ) );
-		_cache.shrink_to_fit();
-//	} catch ( ... ) {
-//	}
+	for ( const auto i : _overlay_used )
+		_overlay._cells[i] = Frame::INVALID;
+	_overlay_used.clear();
+	const auto place{ [this]( const Coord& pos, const char ch, const unsigned short color ) {
+		if ( pos._x < 0 || pos._y < 0 || pos._x >= _size._x || pos._y >= _size._y )
+			return;
+		const auto i{ static_cast<size_t>(pos._y) * static_cast<size_t>(_size._x) + static_cast<size_t>(pos._x) };
+		if ( _overlay._cells[i] == Frame::INVALID ) {
+			_overlay._cells[i] = Frame::pack( ch, color );
+			_overlay_used.push_back( i );
+		}
+	} };
+	// read the actor components straight from the store, in id order
+	const auto& actors{ _game.getActors() };
+	for ( size_t id{ 0u }; id < actors.size(); ++id )
+		if ( actors._used[id] != 0u )
+			place( actors._pos[id], actors._char[id], actors._color[id] );
+	_game.forEachStaticItem( [&place]( const ItemStaticBase& it ) { place( it.pos(), it.getChar(), it.getColor() ); } );
 }
 
 
 /**
  * initFrame(bool)
- * @brief Initializes the frame display. Throws std::exception if cell size is empty.
+ * @brief Initializes the frame display, so that every cell that isn't blank is redrawn by the next frame. Throws std::exception if cell size is empty.
  * @throws std::exception("Cannot initialize an empty cell!") if the cell is empty.
  * @param doCLS	 - (Default: true) When true, the screen buffer is overwritten with blank spaces before initializing the frame.
  */
 void FrameBuffer::initFrame( const bool doCLS )
 {
 	if ( !_initialized ) {
-		if ( _game.getCellSize()._x > 0 && _game.getCellSize()._y > 0 ) {
-			if ( doCLS )
-				sys::cls();			// Clear the screen before initializing
-			_last = buildNextFrame( _origin );	// set the last frame
-			_last.draw();		// draw frame
+		if ( _size._x > 0 && _size._y > 0 ) {
+			if ( doCLS ) {
+				_term.clear();			// Clear the screen before initializing
+				_front.fill( Frame::pack( ' ', Terminal::DEFAULT_COLOR ) ); // the screen is blank now
+			}
+			else _front.invalidate();	// the screen contents are unknown, so every cell is different from the front buffer
+			_shown_stats.reset();
+			_shown_stats_line.clear();
 			_initialized = true;	// set init frame boolean
 		}
 		else
@@ -49,137 +62,235 @@ void FrameBuffer::initFrame( const bool doCLS )
 }
 
 /**
- * checkPos(Coord&)
- * @brief Checks a given position for matches in the cache.
- * @param pos							- Target position.
- * @return nullopt						- No entities are located at the given position.
- * @return pair<char, unsigned short>	- The display character & color of the entity located at the given position.
+ * composeCell(Cell&, long, long, Flare*, unsigned short)
+ * @brief Returns the packed cell shown at a position of the next frame. \n
+ * Known tiles show the entity in the overlay layer if there is one, otherwise their own character, tinted by the flare pattern if a flare is active.
+ * @param cell			- The attached gamespace's cell.
+ * @param x				- The column, this must be within the cell.
+ * @param y				- The row, this must be within the cell.
+ * @param flare			- The active flare, or nullptr.
+ * @param flareColor	- The color of the flare's pattern during this frame.
+ * @returns Frame::Cell
  */
-std::optional<std::pair<char, unsigned short> > FrameBuffer::checkPos( const Coord& pos ) const noexcept
+Frame::Cell FrameBuffer::composeCell( const Cell& cell, const long x, const long y, Flare* const flare, const unsigned short flareColor ) const
 {
-	for ( const auto& it : _cache )
-		if ( pos == std::get<0>( it ) )
-			return std::make_pair( std::get<1>( it ), std::get<2>( it ) );
-	return std::nullopt;
+	if ( !cell.isKnownUnchecked( x, y ) )
+		return Frame::pack( ' ', Terminal::DEFAULT_COLOR );
+	if ( const auto entity{ _overlay.row( y )[x] }; entity != Frame::INVALID )
+		return entity;
+	return Frame::pack( cell.getCharUnchecked( x, y ), flare != nullptr && flare->pattern( x, y ) ? flareColor : Terminal::DEFAULT_COLOR );
 }
 
 /**
- * checkPos(long, long)
- * @brief Checks a given position for matches in the cache.
- * @param x								- Target horizontal X-axis position.
- * @param y								- Target vertical Y-axis position.
- * @return nullopt						- No entities are located at the given position.
- * @return pair<char, unsigned short>	- The display character & color of the entity located at the given position.
+ * composeFrame(Frame&, PendingCells&)
+ * @brief Composes the next frame from current gamespace data, after scatterEntities() was called. \n
+ * Only the cells listed in the slot's pending set are composed, unless the set is marked as full, in which case the whole frame is composed in a single pass.
+ * @param out		- Receives the frame, this must be the same size as the cell & hold the last frame composed into the same slot.
+ * @param pending	- The cells of the slot that changed since the last frame composed into it. This is emptied.
  */
-std::optional<std::pair<char, unsigned short> > FrameBuffer::checkPos( const long x, const long y ) const noexcept { return checkPos( { x, y } ); }
+void FrameBuffer::composeFrame( Frame& out, PendingCells& pending )
+{
+	// the frame is the same size as the cell, so the unchecked cell accessors can be used
+	const auto& cell{ _game.getCell() };
+	auto* const flare{ _game.getFlare() };
+	const auto flareColor{ flare != nullptr && flare->time() % 2 == 0 && flare->time() != 1 ? flare->color() : Terminal::DEFAULT_COLOR };
+	if ( pending._full ) {
+		for ( long y{ 0 }; y < _size._y; ++y ) {
+			auto* const row{ out.row( y ) };
+			for ( long x{ 0 }; x < _size._x; ++x )
+				row[x] = composeCell( cell, x, y, flare, flareColor );
+		}
+	}
+	else {
+		const auto width{ static_cast<size_t>(_size._x) };
+		for ( const auto i : pending._cells )
+			out._cells[i] = composeCell( cell, static_cast<long>(i % width), static_cast<long>(i / width), flare, flareColor );
+	}
+	pending._cells.clear();
+	pending._full = false;
+}
 
 /**
- * buildNextFrame(Coord)
- * @brief Returns a new frame of the entire cell
- * @param origin	- The top-left corner of the frame, as shown in the console screen buffer
- * @returns Frame
+ * markChanged(size_t)
+ * @brief Adds a cell to the pending set of every snapshot slot, so it is composed again the next time a frame is composed into each slot. \n
+ * When a slot collects more changes than a quarter of the cell, the slot is marked as full instead, as composing the whole frame is cheaper at that point.
+ * @param i	- The index of the cell in the frame.
  */
-Frame FrameBuffer::buildNextFrame( const Coord& origin )
+void FrameBuffer::markChanged( const size_t i )
 {
-	rebuildCache();
-	std::vector<std::vector<char> > buffer;
-	//try {
-		buffer.reserve( _size._y );
-		for ( auto y = 0; y < static_cast<signed>(buffer.capacity()); y++ ) {
-			std::vector<char> row;
-			row.reserve( _size._x );
-			for ( auto x = 0; x < static_cast<signed>(row.capacity()); x++ ) {
-				auto pos{ Coord( x, y ) };
-				if ( _game.getTile( pos )->_isKnown ) {
-					const auto entity{ checkPos( pos ) };
-					if ( entity.has_value() )
-						row.emplace_back( entity.value().first );
-					else
-						row.emplace_back( static_cast<char>(_game.getTile( pos )->_display) );
-				}
-				else
-					row.emplace_back( ' ' );
-			}
-			buffer.emplace_back( row );
+	const auto limit{ _overlay._cells.size() / 4u };
+	for ( auto& pending : _pending ) {
+		if ( pending._full )
+			continue;
+		if ( pending._cells.size() >= limit ) {
+			pending._cells.clear();
+			pending._full = true;
+		}
+		else pending._cells.push_back( i );
 	}
-	return Frame{ buffer, origin };
-	//} catch ( ... ) { return {}; }
 }
 
 /**
- * display()
- * @brief (Re)Build the frame from current Gamespace data, and cleanup expired entities by calling Gamespace::cleanupDead().
+ * diffFrames(Frame&)
+ * @brief Compares a frame against the front buffer, and queues every cell that changed to be redrawn. The front buffer is updated to match. \n
+ * Rows are compared several cells at a time first, so rows that didn't change are skipped without looking at individual cells.
+ * @param next	- The frame to draw next.
  */
-void FrameBuffer::display()
+void FrameBuffer::diffFrames( const Frame& next )
 {
-	// flush the stdout buffer
-	fflush( stdout );
-	// Remove dead actors
-	_game.cleanupDead();
-	// get a pointer to the game flare
-	auto* flare{ _game.getFlare() };
-	// Check if the frame is already initialized
-	if ( _initialized ) {
-		// flush the output buffer to prevent garbage characters from being displayed.
-		// Get the new frame
-		auto next = buildNextFrame( _origin );
-		// iterate vertical axis (frame iterator targets cell coords, console iterator targets screen buffer coords)
-		for ( long frameY{ 0 }, consoleY{ _origin._y }; frameY < static_cast<long>(next._frame.size()); frameY++, consoleY++ ) {
-			// iterate horizontal axis for each vertical index
-			for ( long frameX{ 0 }, consoleX{ _origin._x }; frameX < static_cast<long>(next._frame.at( frameY ).size()); frameX++, consoleX++ ) {
-				sys::colorReset();
-				// check if the tile at this pos is known to the player
-				if ( _game.getTile( frameX, frameY )->_isKnown ) {
-					const auto entity{ checkPos( frameX, frameY ) };
-					if ( entity.has_value() ) {
-						sys::cursorPos( consoleX * 2, consoleY );
-						sys::colorSet( entity.value().second );
-						printf( "%c", entity.value().first );
-					}
-						// Check if the game wants a screen color flare
-					else if ( flare != nullptr && flare->pattern( frameX, frameY ) ) {
-						// set the cursor position to target. (frameX is multiplied by 2 because every other column is blank space)
-						sys::cursorPos( consoleX * 2, consoleY );
-						if ( flare->time() % 2 == 0 && flare->time() != 1 ) {
-							sys::colorSet( flare->color() );
-							printf( "%c", next._frame.at( frameY ).at( frameX ) );
-							sys::colorReset();
-						}
-						else
-							printf( "%c", next._frame.at( frameY ).at( frameX ) );
-					}
-						// Selectively update each tile if this tile doesn't match the last frame.
-					else if ( next._frame.at( frameY ).at( frameX ) != _last._frame.at( frameY ).at( frameX ) ) {
-						sys::cursorPos( consoleX * 2, consoleY );
-						printf( "%c", next._frame.at( frameY ).at( frameX ) );
-					}
-				}
-					// Selectively update each unknown tile if this tile doesn't match the last frame.
-				else if ( next._frame.at( frameY ).at( frameX ) != _last._frame.at( frameY ).at( frameX ) ) {
-					sys::cursorPos( consoleX * 2, consoleY );
-					printf( " " );
-				}
+	const auto width{ static_cast<size_t>(_size._x) };
+	for ( long y{ 0 }; y < _size._y; ++y ) {
+		auto* const front{ _front.row( y ) };
+		const auto* const back{ next.row( y ) };
+		if ( Frame::rowEqual( front, back, width ) )
+			continue;
+		for ( long x{ 0 }; x < _size._x; ++x ) {
+			if ( front[x] != back[x] ) {
+				_changes.push_back( { x, y, Frame::color( back[x] ), Frame::glyph( back[x] ) } );
+				front[x] = back[x];
 			}
 		}
-		// set the last frame to this frame.
-		_last = next;
-		// Update the player stats box every other frame
-		if ( _update_stats ) {
-			// display the player stat bar
-			_player_stats.display();
-			_update_stats = false;
+	}
+}
+
+/**
+ * encodeChanges()
+ * @brief Writes the cells queued by diffFrames() to the terminal buffer, and empties the queue. \n
+ * Tiles are sorted by color, then by row & column, so each color is only set once per frame. \n
+ * Tiles of the same color that are next to each other in a row are merged into a run, which is written after a single cursor move. \n
+ * The blank column between two tiles of a run is written as a space, unless the run's color has a background.
+ */
+void FrameBuffer::encodeChanges()
+{
+	std::sort( _changes.begin(), _changes.end(), []( const TileChange& a, const TileChange& b ) {
+		return a._color != b._color ? a._color < b._color : a._y != b._y ? a._y < b._y : a._x < b._x;
+	} );
+
+	const auto digits{ []( long value ) {
+		size_t count{ 1u };
+		for ( ; value >= 10; value /= 10 )
+			++count;
+		return count;
+	} };
+	const auto begin{ _term.size() };
+	_stats._tiles = _changes.size();
+	_stats._runs = 0u;
+	_stats._unbatched_bytes = 0u;
+	const TileChange* prev{ nullptr };
+	for ( const auto& it : _changes ) {
+		// frameX is multiplied by 2 because every other column is blank space
+		const auto consoleX{ ( _origin._x + it._x ) * 2 }, consoleY{ _origin._y + it._y };
+		_term.color( it._color );
+		if ( prev != nullptr && prev->_color == it._color && prev->_y == it._y && prev->_x + 1 == it._x ) { // continue the run
+			if ( Terminal::hasBackground( it._color ) )
+				_term.moveTo( consoleX, consoleY ); // skip over the blank column without coloring it
+			else _term.put( ' ' );
 		}
-		else
-			_update_stats = true;
-		// do flare functions
-		if ( flare != nullptr ) {
-			if ( flare->time() > 1 )
-				flare->decrement();
-			else
-				_game.resetFlare();
+		else {
+			++_stats._runs;
+			_term.moveTo( consoleX, consoleY );
 		}
+		_term.put( it._ch );
+		prev = &it;
+		// a cursor move & the glyph, plus a color & a color reset for colored tiles
+		_stats._unbatched_bytes += 4u + digits( consoleY + 1 ) + digits( consoleX + 1 ) + 1u + ( it._color != Terminal::DEFAULT_COLOR ? 15u : 0u );
+	}
+	_stats._bytes = _term.size() - begin;
+	_stats._total_bytes += _stats._bytes;
+	_stats._total_unbatched_bytes += _stats._unbatched_bytes;
+	_changes.clear();
+}
+
+/**
+ * displayStats()
+ * @brief Writes the output statistics of the last frame below the player stat box, if they are shown & changed since they were last drawn. \n
+ * The line shows the number of redrawn tiles, the bytes used to encode them compared to drawing each tile separately, and the percentage saved over the whole game.
+ */
+void FrameBuffer::displayStats()
+{
+	if ( !_show_stats )
+		return;
+	auto line{ "Tiles: " + std::to_string( _stats._tiles ) + "  Bytes: " + std::to_string( _stats._bytes ) + " / " + std::to_string( _stats._unbatched_bytes ) + "  Saved: " + std::to_string( _stats.savedPercent() ) + "%" };
+	if ( line == _shown_stats_line )
+		return;
+	const auto length{ line.size() };
+	if ( line.size() < _shown_stats_line.size() ) // overwrite the end of a longer line
+		line.append( _shown_stats_line.size() - line.size(), ' ' );
+	const auto pos{ _player_stats.below() };
+	_term.reset();
+	_term.moveTo( pos._x, pos._y );
+	_term.put( line );
+	line.resize( length );
+	_shown_stats_line = std::move( line );
+}
+
+/**
+ * publish()
+ * @brief Composes the next frame & player stats from current Gamespace data, and makes them available to draw(). \n
+ * Only the cells that changed since a frame was last composed into the same snapshot slot are composed again: tiles from the gamespace's dirty list, and tiles that an entity was located on. \n
+ * This is the only part of a frame that reads the gamespace, so it must be called while the gamespace isn't being modified, such as at the end of a tick.
+ */
+void FrameBuffer::publish()
+{
+	// tiles that were revealed or hidden
+	_game.takeDirtyTiles( _dirty );
+	for ( const auto& pos : _dirty )
+		if ( pos._x >= 0 && pos._y >= 0 && pos._x < _size._x && pos._y < _size._y )
+			markChanged( static_cast<size_t>(pos._y) * static_cast<size_t>(_size._x) + static_cast<size_t>(pos._x) );
+	// tiles that an entity was located on during the last frame, or is located on now
+	for ( const auto i : _overlay_used )
+		markChanged( i );
+	scatterEntities();
+	for ( const auto i : _overlay_used )
+		markChanged( i );
+	// a flare recolors tiles across the cell every frame, so frames are composed in full while one is active & once more after it ends
+	const auto flareActive{ _game.getFlare() != nullptr };
+	if ( flareActive || _flare_shown )
+		for ( auto& pending : _pending )
+			pending._full = true;
+	_flare_shown = flareActive;
+	auto& snapshot{ _snapshots.writeSlot() };
+	composeFrame( snapshot._frame, _pending[_snapshots.writeIndex()] );
+	snapshot._player.assign( _game.getPlayer() );
+	snapshot._published = true;
+	_snapshots.publish();
+}
+
+/**
+ * draw()
+ * @brief Draws the latest frame published by publish() to the console, initializing the display first if it isn't initialized yet. \n
+ * Only the cells that differ from the front buffer are redrawn, and nothing is drawn if no frame was published since the last call. \n
+ * The whole frame is encoded into the terminal buffer first, and written to the console with a single system call at the end. \n
+ * This doesn't read the gamespace, so it can be called from a display thread while the simulation keeps running.
+ */
+void FrameBuffer::draw()
+{
+	const auto fresh{ _snapshots.acquire() };
+	const auto& snapshot{ _snapshots.readSlot() };
+	if ( !snapshot._published || ( _initialized && !fresh ) )
+		return;
+	// if the frame hasn't been initialized, initialize it.
+	initFrame();
+	diffFrames( snapshot._frame );
+	encodeChanges();
+	// Update the player stats box when the stats changed
+	if ( _shown_stats != snapshot._player ) {
+		_player_stats.display( _term, snapshot._player );
+		_shown_stats = snapshot._player;
 	}
-	else initFrame(); // if the frame hasn't been initialized, initialize it.
+	_stats._frame_bytes = _term.size();
+	displayStats();
+	_term.flush();
+}
+
+/**
+ * display()
+ * @brief Publish a frame from current Gamespace data & draw it. Equivalent to calling publish() then draw().
+ */
+void FrameBuffer::display()
+{
+	publish();
+	draw();
 }
 
 /**
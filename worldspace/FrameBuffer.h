@@ -1,8 +1,11 @@
 #pragma once
+#include <array>
+#include <optional>
 
 #include "Frame.h"
 #include "PlayerStatBox.h"
 #include "Gamespace.h"
+#include "triplebuffer.h"
 
 /**
  * initConsole()
@@ -33,42 +36,119 @@
 	) && sys::cursorVisible( false );
 }
 
+/**
+ * @struct FrameStats
+ * @brief Output statistics of the last frame drawn by a FrameBuffer.
+ */
+struct FrameStats {
+	size_t _tiles{ 0u },			///< @brief The number of tiles that were redrawn.
+		   _runs{ 0u },				///< @brief The number of runs the redrawn tiles were merged into, each run starts with a cursor move.
+		   _bytes{ 0u },			///< @brief The number of bytes used to encode the redrawn tiles.
+		   _unbatched_bytes{ 0u },	///< @brief The number of bytes the redrawn tiles would have used with a cursor move, a color, and a color reset for each tile.
+		   _frame_bytes{ 0u };		///< @brief The total number of bytes written for the frame, including the player stat box.
+	unsigned long long
+		_total_bytes{ 0ull },			///< @brief The sum of _bytes over every frame drawn so far.
+		_total_unbatched_bytes{ 0ull };	///< @brief The sum of _unbatched_bytes over every frame drawn so far.
+
+	/**
+	 * savedPercent()
+	 * @brief Returns the percentage of bytes saved over every frame drawn so far, compared to drawing each tile separately.
+	 * @returns unsigned long long
+	 */
+	[[nodiscard]] unsigned long long savedPercent() const noexcept { return _total_unbatched_bytes > _total_bytes ? ( _total_unbatched_bytes - _total_bytes ) * 100ull / _total_unbatched_bytes : 0ull; }
+};
+
+/**
+ * @struct RenderSnapshot
+ * @brief A copy of everything needed to draw a frame, so that it can be drawn without reading the gamespace.
+ */
+struct RenderSnapshot {
+	Frame _frame;				///< @brief The composed frame: known tiles, entities, and the active flare's colors.
+	PlayerStats _player;		///< @brief The stats shown in the player stat box.
+	bool _published{ false };	///< @brief This is false until a frame was composed into this snapshot.
+};
+
 /**
  * @struct FrameBuffer
- * @brief Double-Buffered console rendering using the Frame struct.
+ * @brief Double-Buffered console rendering using the Frame struct. \n
+ * The simulation composes each frame into a RenderSnapshot with publish(), which is passed to the display through a lock-free triple buffer. \n
+ * draw() compares the latest snapshot against the front buffer to find the cells that changed, and only redraws those. \n
+ * publish() & draw() can be called from different threads at the same time, as long as each one is only called from a single thread, and publish() is only called while the gamespace isn't being modified.
  */
 class FrameBuffer {
+	/**
+	 * @struct TileChange
+	 * @brief A tile that is different from the last frame, and needs to be redrawn.
+	 */
+	struct TileChange {
+		long _x, _y;			///< @brief The position of the tile in the cell.
+		unsigned short _color;	///< @brief The color to draw the tile with.
+		char _ch;				///< @brief The character to draw.
+	};
+
+	/**
+	 * @struct PendingCells
+	 * @brief The cells of a snapshot slot that changed since a frame was last composed into that slot.
+	 */
+	struct PendingCells {
+		std::vector<size_t> _cells;	///< @brief The indexes of the changed cells, may contain duplicates.
+		bool _full{ true };			///< @brief When true, every cell must be composed, such as before the first frame composed into the slot.
+	};
+
 	Gamespace& _game;							///< @brief A reference to the attached gamespace.
 	Coord _window_origin,							///< @brief This is the origin point of the console window on the desktop.
 		  _size;									///< @brief This is the size/bottom-right-corner of the cell.
 	bool _initialized{ false },					///< @brief This is used to re-initialize the frame when the game is unpaused.
-		 _update_stats{ true },					///< @brief This is used to update the player stat box every other frame.
-		 _console_initialized{ false };			///< @brief This is used to determine whether the console window was initialized or not.
+		 _console_initialized{ false },			///< @brief This is used to determine whether the console window was initialized or not.
+		 _show_stats{ false };					///< @brief When true, the output statistics are shown below the player stat box.
 	Coord _origin;								///< @brief This is the origin of the cell in the screen buffer.
-	Frame _last;								///< @brief The last frame printed to the console.
+	Frame _front;								///< @brief The frame currently shown in the console. Only accessed by draw().
+	TripleBuffer<RenderSnapshot> _snapshots;	///< @brief Passes composed frames from publish() to draw().
+	Terminal _term;								///< @brief Output buffer that every frame is encoded into, and written from with a single system call.
 	PlayerStatBox _player_stats;				///< @brief Responsible for the player stats display.
-	std::vector<std::tuple<Coord, char, unsigned short> > _cache; ///< @brief Contains display information about actors & items.
+	std::optional<PlayerStats> _shown_stats;	///< @brief The player stats currently shown in the console, the stat box is only redrawn when they change.
+	Frame _overlay;								///< @brief The entity layer of the current frame, each tile holds the packed cell of the entity located on it, or Frame::INVALID.
+	std::vector<size_t> _overlay_used;			///< @brief The indexes of the overlay cells that hold an entity, so they can be cleared without clearing the whole layer.
+	std::vector<Coord> _dirty;					///< @brief Receives the gamespace's dirty tile list.
+	std::array<PendingCells, TripleBuffer<RenderSnapshot>::SLOTS> _pending; ///< @brief The changed cells of each snapshot slot, indexed by slot. Only accessed by publish().
+	bool _flare_shown{ false };					///< @brief True when a flare was active during the last call to publish().
+	std::vector<TileChange> _changes;			///< @brief The cells that changed since the last frame, collected by diffFrames() & written by encodeChanges().
+	FrameStats _stats;							///< @brief Output statistics of the last frame.
+	std::string _shown_stats_line;				///< @brief The output statistics line currently shown in the console, it is only redrawn when it changes.
 
-	void rebuildCache() noexcept;
+	void scatterEntities();
 	void initFrame( bool doCLS = true );
-	[[nodiscard]] std::optional<std::pair<char, unsigned short> > checkPos( const Coord& pos ) const noexcept;
-	[[nodiscard]] std::optional<std::pair<char, unsigned short> > checkPos( long x, long y ) const noexcept;
-	[[nodiscard]] Frame buildNextFrame( const Coord& origin );
+	[[nodiscard]] Frame::Cell composeCell( const Cell& cell, long x, long y, Flare* flare, unsigned short flareColor ) const;
+	void composeFrame( Frame& out, PendingCells& pending );
+	void markChanged( size_t i );
+	void diffFrames( const Frame& next );
+	void encodeChanges();
+	void displayStats();
 
 public:
 	/**
-	 * FrameBuffer(Cell&, Coord&, Coord&)
+	 * FrameBuffer(Cell&, Coord&, bool, bool)
 	 * @brief Instantiate a FrameBuffer display. Throws std::exception if console window did not initialize correctly.
 	 * @param gamespace		- Reference to the attached Gamespace instance
 	 * @param windowOrigin	- (Default: (1,1)) Position of the window on the monitor
 	 * @param showPlayerValues	- (Default: false) When true, displays the raw stat values below the stat bars.
+	 * @param showFrameStats	- (Default: false) When true, displays the output statistics of each frame below the player stat box.
 	 */
-	explicit FrameBuffer( Gamespace& gamespace, const Coord& windowOrigin = Coord( 1, 1 ), const bool showPlayerValues = false ) : _game( gamespace ), _window_origin( windowOrigin ), _size( gamespace.getCellSize() ), _console_initialized( initConsole( _window_origin, _size ) ), _origin( { sys::getScreenBufferCenter()._x - _size._x - 1, sys::getScreenBufferCenter()._y - _size._y / 2L - ( showPlayerValues ? 4 : 3 ) - 2 } ), _player_stats( &_game.getPlayer(), { _origin._x + _size._x, _origin._y + _size._y + 1 }, showPlayerValues )
+	explicit FrameBuffer( Gamespace& gamespace, const Coord& windowOrigin = Coord( 1, 1 ), const bool showPlayerValues = false, const bool showFrameStats = false ) : _game( gamespace ), _window_origin( windowOrigin ), _size( gamespace.getCellSize() ), _console_initialized( initConsole( _window_origin, _size ) ), _show_stats( showFrameStats ), _origin( { sys::getScreenBufferCenter()._x - _size._x - 1, sys::getScreenBufferCenter()._y - _size._y / 2L - ( showPlayerValues ? 4 : 3 ) - ( showFrameStats ? 1 : 0 ) - 2 } ), _front( _size ), _snapshots( RenderSnapshot{ Frame( _size ), {}, false } ), _term( static_cast<size_t>(_size._x * _size._y) * Terminal::BYTES_PER_CELL + 1024u ), _player_stats( { _origin._x + _size._x, _origin._y + _size._y + 1 }, showPlayerValues ), _overlay( _size )
 	{
 		if ( !_console_initialized )
 			throw std::exception( "The console window failed to initialize." );
 	}
 
+	/**
+	 * stats()
+	 * @brief Returns the output statistics of the last frame.
+	 * @returns FrameStats&
+	 */
+	[[nodiscard]] const FrameStats& stats() const noexcept { return _stats; }
+
+	void publish();
+	void draw();
 	void display();
 	void deinitialize() noexcept;
 };
@@ -36,6 +36,7 @@ public:
 		_override_known_tiles{ false },		///< @brief When true, the player can always see all tiles. Disables dark mode.
 		_dark_mode{ false };				///< @brief When true, the player can only see the area around them.
 	Coord _cellSize{ 30, 30 };				///< @brief If no filename is set, this is the size of the generated cell
+	unsigned _seed{ 0u };					///< @brief The world seed that every random number is derived from. When 0, a random seed is used.
 
 	/// TRAPS
 	int _trap_dmg{ 20 };					///< @brief the amount of health an actor loses when they step on a trap
@@ -60,6 +61,12 @@ public:
 		_npc_move_chance{ 60.0f },			///< @brief The chance an NPC will move when idle
 		_npc_move_chance_aggro{ 90.0f };	///< @brief The chance an NPC will move when aggravated
 	int _npc_vis_mod_aggro{ 1 };			///< @brief This value is added to an NPC's sight range when chasing target
+	long
+		_npc_lod_near_range{ 24 },			///< @brief NPCs whose vision reaches within this many tiles of the player act every NPC cycle
+		_npc_lod_far_range{ 64 };			///< @brief NPCs whose vision doesn't reach within this many tiles of the player act every _npc_lod_far_rate cycles
+	unsigned
+		_npc_lod_mid_rate{ 2 },				///< @brief NPCs between the near & far ranges act once every this many NPC cycles
+		_npc_lod_far_rate{ 8 };				///< @brief NPCs beyond the far range act once every this many NPC cycles
 	bool _level_stat_mult{ true };
 
 	/// ENEMIES
@@ -125,6 +132,9 @@ public:
 		_enable_boss{ true }, ///< @brief When true, a boss will spawn before the end of the game
 		_boss_spawns_after_final{ true }; ///< @brief When true, the boss will only spawn after the final challenge.
 
+	/// DISPLAY
+	bool _show_frame_stats{ false };		///< @brief When true, a line showing how many bytes each frame took to draw is displayed below the player stats.
+
 	///< @brief Possible messages to show for "killed by:" when player died from a trap
 	std::vector<std::string> _killed_by_trap{
 		"trap",
@@ -169,6 +179,7 @@ public:
 		_override_known_tiles			(cfg.get<bool>	("world", "showAllTiles", str::stob).value_or(_override_known_tiles)),
 		_dark_mode						(cfg.get<bool>	("world", "fogOfWar", str::stob).value_or(_dark_mode)),
 		_cellSize						(cfg.get<long>	("world", "sizeH", str::stol).value_or(_cellSize._x), cfg.get<long>("world", "sizeV", str::stol).value_or(_cellSize._y)),
+		_seed							(cfg.get<unsigned>("world", "seed", str::stoui).value_or(_seed)),
 		_trap_dmg						(cfg.get<int>	("world", "trapDamage", str::stoi).value_or(_trap_dmg)),
 		_trap_percentage				(cfg.get<bool>	("world", "trapDamageIsPercentage", str::stob).value_or(_trap_percentage)),
 		_attack_cost_stamina			(cfg.get<int>	("actors", "attackCostStamina", str::stoi).value_or(_attack_cost_stamina)),
@@ -179,6 +190,10 @@ public:
 		_npc_move_chance				(cfg.get<float>	("actors", "npcMoveChance", str::stof).value_or(_npc_move_chance)),
 		_npc_move_chance_aggro			(cfg.get<float>	("actors", "npcMoveChanceAggro", str::stof).value_or(_npc_move_chance_aggro)),
 		_npc_vis_mod_aggro				(cfg.get<int>	("actors", "npcVisModAggro", str::stoi).value_or(_npc_vis_mod_aggro)),
+		_npc_lod_near_range				(cfg.get<long>	("actors", "npcLodNearRange", str::stol).value_or(_npc_lod_near_range)),
+		_npc_lod_far_range				(cfg.get<long>	("actors", "npcLodFarRange", str::stol).value_or(_npc_lod_far_range)),
+		_npc_lod_mid_rate				(cfg.get<unsigned>("actors", "npcLodMidRate", str::stoui).value_or(_npc_lod_mid_rate)),
+		_npc_lod_far_rate				(cfg.get<unsigned>("actors", "npcLodFarRate", str::stoui).value_or(_npc_lod_far_rate)),
 		_level_stat_mult				(cfg.get<bool>("actors", "multStatsByLevel", str::stob)),
 		_enemy_count					(cfg.get<int>	("enemy", "count", str::stoi).value_or(_enemy_count)),
 		_enemy_aggro_distance			(cfg.get<int>	("enemy", "aggroDistance", str::stoi).value_or(_enemy_aggro_distance)),
@@ -190,7 +205,8 @@ public:
 //		_level_up_mult					(cfg.get<int>	("player", "levelKillMult", str::stoi).value_or(_level_up_mult)),
 		_level_up_restore_percent		(cfg.get<int>	("actors", "levelRestorePercent", str::stoi).value_or(_level_up_restore_percent)),
 		_enable_boss					(cfg.get<bool>	("enemy", "enable_boss", str::stob).value_or(_enable_boss)),
-		_boss_spawns_after_final		(cfg.get<bool>	("enemy", "bossDelayedSpawn", str::stob).value_or(_boss_spawns_after_final))
+		_boss_spawns_after_final		(cfg.get<bool>	("enemy", "bossDelayedSpawn", str::stob).value_or(_boss_spawns_after_final)),
+		_show_frame_stats				(cfg.get<bool>	("timing", "showFrameStats", str::stob).value_or(_show_frame_stats))
 	{
 		assert(!cfg.empty());
 		///< @brief Set player stats
@@ -10,4 +10,5 @@ struct GameState {
 		_allEnemiesDead{ false },	// When true, the player wins.
 		_playerDead{ false },		// When true, the player loses.
 		_game_is_over{ false };		// When true, the game is over.
+	std::atomic<unsigned long long> _tick{ 0ull }; // The number of fixed-length simulation ticks that have finished since the game started.
 };
\ No newline at end of file
@@ -6,37 +6,75 @@
  * @brief Creates a new gamespace with the given settings.
  * @param ruleset	 - A ref to the ruleset structure
  */
-Gamespace::Gamespace(GameRules& ruleset) noexcept : _ruleset(ruleset), _world(Cell{ _ruleset._cellSize, _ruleset._walls_always_visible, _ruleset._override_known_tiles }), _player({ findValidSpawn(true), _ruleset._player_template }), _FLARE_DEF_CHALLENGE(_world._max), _FLARE_DEF_BOSS(_world._max)
+Gamespace::Gamespace(GameRules& ruleset) noexcept : _ruleset(ruleset), _seed(_ruleset._seed != 0u ? _ruleset._seed : std::random_device{}()), _world(Cell{ _ruleset._cellSize, _ruleset._walls_always_visible, _ruleset._override_known_tiles, CounterRNG{ _seed, WORLD } }), _occupancy(_world._max), _max_vis(max_vis_range(_ruleset)), _actor_hash(_world._max, _max_vis), _spawn_pool(build_spawn_pool(_world)), _player_flow(_world._max), _pathfinder(_world._max), _clusters(_world.getMovePlane()), _lod(_ruleset._npc_lod_near_range, _ruleset._npc_lod_far_range, _ruleset._npc_lod_mid_rate, _ruleset._npc_lod_far_rate), _rng(_seed, GAMESPACE), _player(_actors, findValidSpawn(true), _ruleset._player_template), _FLARE_DEF_CHALLENGE(_world._max), _FLARE_DEF_BOSS(_world._max)
 {
+	_occupancy.setActor(_player.pos(), &_player);
+	refresh_spawn(_player.pos());
 	_hostile = generate_NPCs<Enemy>(ruleset._enemy_count, ruleset._enemy_template);
 	_neutral = generate_NPCs<Neutral>(ruleset._neutral_count, ruleset._neutral_template);
 	_item_static_health = generate_items<ItemStaticHealth>(10, true);
 	_item_static_stamina = generate_items<ItemStaticStamina>(10);
-	_world.modVisCircle(true, _player.pos(), _player.getVis() + 2); // allow the player to see the area around them
+	// the generated vectors were moved into their members, re-point the occupancy grid at their final addresses
+	index_all(_hostile);
+	index_all(_neutral);
+	index_all(_item_static_health);
+	index_all(_item_static_stamina);
+	rehash_actors();
+	update_reveal();
 }
 #pragma endregion		GAME_CONSTRUCTOR
 // Gamespace functions related to creating objects in the cell.
 #pragma region GAME_SPAWNING
+/**
+ * build_spawn_pool(Cell&)
+ * @brief Creates a spawn pool containing every tile of a cell that entities are allowed to spawn on.
+ * @param cell			- Target cell
+ * @returns SpawnPool
+ */
+SpawnPool Gamespace::build_spawn_pool(Cell& cell)
+{
+	SpawnPool pool{ cell._max };
+	for ( auto y{ 0L }; y < cell._max._y; ++y )
+		for ( auto x{ 0L }; x < cell._max._x; ++x )
+			if ( cell.canSpawn({ x, y }) )
+				pool.insert({ x, y });
+	return pool;
+}
+/**
+ * refresh_spawn(Coord&)
+ * @brief Adds or removes a tile from the spawn pool, depending on whether it is spawnable & unoccupied. \n
+ * This must be called whenever an actor or static item arrives at, or leaves, a tile.
+ * @param pos	- Target position
+ */
+void Gamespace::refresh_spawn(const Coord& pos)
+{
+	if ( _world.canSpawn(pos) && getActorAt(pos) == nullptr && getItemAt(pos) == nullptr )
+		_spawn_pool.insert(pos);
+	else
+		_spawn_pool.erase(pos);
+}
+/**
+ * next_stream()
+ * @brief Returns the random number stream of a new entity. Each call uses the next stream id, so entities spawned in the same order always get the same streams.
+ * @returns CounterRNG
+ */
+CounterRNG Gamespace::next_stream() { return CounterRNG{ _seed, _next_stream++ }; }
 /**
  * findValidSpawn()
- * @brief Returns the coordinate of a valid NPC spawn position. The player must already be initialized.
+ * @brief Returns a random spawnable tile that is not occupied by an actor or static item. \n
+ * Tiles are picked from the spawn pool, and each rejected tile is moved past the end of the range being picked from, so no tile is tried twice.
  * @param isPlayer		- When true, does not check positions for proximity to the player.
- * @param checkForItems	- When true, does not check positions for static items.
  * @returns Coord
  * @throws std::exception() - Couldn't find a valid spawn location.
  */
-Coord Gamespace::findValidSpawn(const bool isPlayer, const bool checkForItems)
-{
-	// calculate max possible valid positions, set it as max
-	const int max_checks{ (_world._max._x - 2) * (_world._max._y - 2) };
-	// loop
-	for ( auto i{ 0 }; i < max_checks; i++ ) {
-		Coord pos{ 0, 0 };
-		for ( auto findPos{ pos }; !_world.get(findPos)->_canSpawn; pos = findPos )
-			findPos = { _rng.get(_world._max._x - 2, 1), _rng.get(_world._max._y - 2, 1) };
-		// Check if this pos is valid
-		if ( !checkForItems ? true : getItemAt(pos) == nullptr && isPlayer ? true : getActorAt(pos) == nullptr && getDist(_player.pos(), pos) >= _ruleset._enemy_aggro_distance + _player.getVis() * 2 )
+Coord Gamespace::findValidSpawn(const bool isPlayer)
+{
+	for ( auto remaining{ _spawn_pool.size() }; remaining > 0u; --remaining ) {
+		const auto i{ static_cast<size_t>(_rng.get(static_cast<unsigned int>(remaining) - 1u, 0u)) };
+		const auto pos{ _spawn_pool.at(i) };
+		if ( isPlayer || getDist(_player.pos(), pos) >= _ruleset._enemy_aggro_distance + _player.getVis() * 2 )
 			return pos;
+		_spawn_pool.swap(i, remaining - 1u);
 	}
 	throw std::exception("Failed to find a valid spawn, are there enough empty tiles?");
 }
@@ -61,7 +99,10 @@ std::vector<Actor> Gamespace::generate_NPCs(const int count, std::vector<ActorTe
 				break;
 			}
 		}
-		v.push_back({ findValidSpawn(), templates.at(sel < templates.size() ? sel : 0) });
+		v.push_back({ _actors, findValidSpawn(), templates.at(sel < templates.size() ? sel : 0) });
+		v.back().rng() = next_stream();
+		_occupancy.setActor(v.back().pos(), &v.back()); // reserved above, so this address is stable until v is moved
+		refresh_spawn(v.back().pos());
 	}
 	v.shrink_to_fit();
 	return v;
@@ -83,6 +124,8 @@ std::vector<Item> Gamespace::generate_items(const int count, const bool lockToPl
 			v.emplace_back(Item{ findValidSpawn(), 50, { FACTION::PLAYER } });
 		else
 			v.emplace_back(Item{ findValidSpawn(), 50 });
+		_occupancy.setItem(v.back().pos(), &v.back());
+		refresh_spawn(v.back().pos());
 	}
 	v.shrink_to_fit();
 	return v;
@@ -96,7 +139,9 @@ std::vector<Item> Gamespace::generate_items(const int count, const bool lockToPl
  */
 template<typename NPC> NPC Gamespace::build_npc(ActorTemplate& actorTemplate)
 {
-	return{ findValidSpawn(), actorTemplate };
+	NPC npc{ _actors, findValidSpawn(), actorTemplate };
+	npc.rng() = next_stream();
+	return npc;
 }
 /**
  * spawn(ActorTemplate&)
@@ -108,16 +153,126 @@ template<typename NPC> NPC Gamespace::build_npc(ActorTemplate& actorTemplate)
  */
 template<typename NPC> NPC Gamespace::build_npc(const Coord& pos, ActorTemplate& actorTemplate)
 {
-	if ( _world.isValidPos(pos) )
-		return{ pos, actorTemplate };
+	if ( _world.isValidPos(pos) ) {
+		NPC npc{ _actors, pos, actorTemplate };
+		npc.rng() = next_stream();
+		return npc;
+	}
 	throw std::exception("Attempted to create an NPC at an invalid position.");
 }
 
+/**
+ * spawn_boss()
+ * @brief Spawns a randomly selected boss enemy, and queues the boss flare.
+ */
 void Gamespace::spawn_boss()
 {
+	const auto* const data{ _hostile.data() };
 	_hostile.push_back( build_npc<Enemy>( _ruleset._enemy_boss_template.at( _rng.get( static_cast<unsigned int>(_ruleset._enemy_boss_template.size()) - 1u, 0u ) ) ) );
+	// if the vector reallocated, every enemy moved
+	if ( data == _hostile.data() ) {
+		index_all(_hostile, _hostile.size() - 1u);
+		_actor_hash.insert(&_hostile.back());
+	}
+	else {
+		index_all(_hostile);
+		rehash_actors();
+	}
+	refresh_spawn(_hostile.back().pos());
+	stimulate(_hostile.back().pos());
 	addFlare(_FLARE_DEF_BOSS);
 }
+
+/**
+ * index_all(vector<T>&, size_t)
+ * @brief (Re)Registers the elements of an actor or static item vector with the occupancy grid. \n
+ * This must be called whenever elements of the vector may have changed address, starting from the first element that moved.
+ * @tparam T		- Actor or static item type.
+ * @param vec		- Ref to a vector of actors or static items.
+ * @param first		- (Default: 0) Index of the first element to register.
+ */
+template<typename T>
+void Gamespace::index_all(std::vector<T>& vec, size_t first)
+{
+	for ( ; first < vec.size(); ++first ) {
+		if constexpr ( std::is_base_of_v<ActorBase, T> )
+			_occupancy.setActor(vec[first].pos(), &vec[first]);
+		else
+			_occupancy.setItem(vec[first].pos(), &vec[first]);
+	}
+}
+/**
+ * remove_expired(vector<T>&)
+ * @brief Removes dead actors or used up static items from a vector, and unregisters them from the occupancy grid, spatial hash & actor store. \n
+ * Each element is removed by moving the last element into its place, so removing any number of elements is linear & only the moved elements need to be re-registered. \n
+ * Moved actors update their address in the actor store themselves, so handles to them stay valid.
+ * @tparam T		- Actor or static item type.
+ * @param vec		- Ref to a vector of actors or static items.
+ */
+template<typename T>
+void Gamespace::remove_expired(std::vector<T>& vec)
+{
+	for ( size_t i{ 0u }; i < vec.size(); ) {
+		auto& it{ vec[i] };
+		const auto pos{ it.pos() };
+		if constexpr ( std::is_base_of_v<ActorBase, T> ) {
+			if ( !it.isDead() ) {
+				++i;
+				continue;
+			}
+			_occupancy.removeActor(pos, &it);
+			_actor_hash.remove(&it, pos);
+			_actors.release(it.id());
+			stimulate(pos); // a closer actor may have been hidden behind this one
+		}
+		else {
+			if ( it.getUses() > 0 ) {
+				++i;
+				continue;
+			}
+			_occupancy.removeItem(pos, &it);
+		}
+		if ( auto& last{ vec.back() }; &last != &it ) { // swap & pop, the last element moves into the gap
+			if constexpr ( std::is_base_of_v<ActorBase, T> ) {
+				_actor_hash.remove(&last, last.pos());
+				it = std::move(last);
+				_occupancy.setActor(it.pos(), &it);
+				_actor_hash.insert(&it);
+			}
+			else {
+				it = std::move(last);
+				_occupancy.setItem(it.pos(), &it);
+			}
+		}
+		vec.pop_back();
+		refresh_spawn(pos); // the element at i is checked again, as it is the one that was moved there
+	}
+}
+/**
+ * rehash_actors()
+ * @brief Clears the spatial hash, and re-inserts every actor. This must be called whenever actors are removed, or may have changed address.
+ */
+void Gamespace::rehash_actors()
+{
+	_actor_hash.clear();
+	for ( auto* it : get_all_actors() )
+		_actor_hash.insert(it);
+}
+/**
+ * max_vis_range(GameRules&)
+ * @brief Returns the largest vision range of all actor templates in a ruleset, this is used as the spatial hash bucket size.
+ * @param ruleset	- Target ruleset
+ * @returns long
+ */
+long Gamespace::max_vis_range(const GameRules& ruleset)
+{
+	long range{ ruleset._player_template._stats.getVis() };
+	for ( const auto* list : { &ruleset._enemy_template, &ruleset._enemy_boss_template, &ruleset._neutral_template } )
+		for ( const auto& it : *list )
+			if ( it._stats.getVis() > range )
+				range = it._stats.getVis();
+	return range;
+}
 #pragma endregion			GAME_SPAWNING
 // Gamespace functions that apply other functions to multiple types of objects.
 #pragma region GAME_APPLY_TO_TYPE
@@ -201,44 +356,23 @@ std::vector<ItemStaticBase*> Gamespace::get_all_static_items()
 }
 /**
  * getClosestActor(Coord&, int)
- * @brief Returns a pointer to the closest actor to a given position.
+ * @brief Returns a pointer to the closest actor to a given position, not including the actor located at that position.
  * @param pos		- Position ref
- * @param visRange	- Range to check in all directions around the position ref
+ * @param visRange	- Radius to check around the position ref
  * @returns ActorBase*
  */
 ActorBase* Gamespace::getClosestActor(const Coord& pos, const int visRange)
 {
-	ActorBase* nearest{ nullptr };
-	auto dist{ -1 };
-	for ( auto y{ pos._y - visRange }; y < pos._y + visRange; ++y ) {
-		for ( auto x{ pos._x - visRange }; x < pos._x + visRange; ++x ) {
-			auto* const here{ getActorAt(x, y) };
-			if ( here != nullptr ) {
-				const auto dist_here{ getDist(x, y, here->pos()._x, here->pos()._y) };
-				if ( dist == -1 || dist_here < dist ) {
-					nearest = here;
-					dist = dist_here;
-				}
-				if ( dist == 1 )
-					break;
-			}
-		}
-	}
-	return nearest;
+	_actor_hash.nearest(pos, visRange, 1u, FACTION_MASK_ALL, _nearby, getActorAt(pos));
+	return _nearby.empty() ? nullptr : _nearby.front();
 }
 /**
  * getActorAt(Coord)
- * @brief Returns a pointer to an actor located at a given tile.
+ * @brief Returns a pointer to an actor located at a given tile. This is a constant-time lookup in the occupancy grid.
  * @param pos			- The target tile
  * @returns ActorBase*	- nullptr if not found
  */
-ActorBase* Gamespace::getActorAt(const Coord& pos)
-{
-	for ( auto* it : get_all_actors() ) {
-		if ( pos == it->pos() ) return it;
-	}
-	return nullptr;
-}
+ActorBase* Gamespace::getActorAt(const Coord& pos) { return _occupancy.getActor(pos); }
 /**
  * getActorAt(int, int)
  * @brief Returns a pointer to an actor located at a given tile.
@@ -246,26 +380,14 @@ ActorBase* Gamespace::getActorAt(const Coord& pos)
  * @param posY			- The target tile's Y (vertical) index
  * @returns ActorBase*	- nullptr if not found
  */
-ActorBase* Gamespace::getActorAt(const int posX, const int posY)
-{
-	for ( auto* it : get_all_actors() ) {
-		if ( posX == it->pos()._x && posY == it->pos()._y ) return it;
-	}
-	return nullptr;
-}
+ActorBase* Gamespace::getActorAt(const int posX, const int posY) { return _occupancy.getActor(posX, posY); }
 /**
  * getItemAt(Coord)
  * @brief Returns a pointer to an actor located at a given tile.
  * @param pos				- The target tile
  * @returns ItemStaticBase*	- nullptr if not found
  */
-ItemStaticBase* Gamespace::getItemAt(const Coord& pos)
-{
-	for ( auto* it : get_all_static_items() ) {
-		if ( pos == it->pos() ) return it;
-	}
-	return nullptr;
-}
+ItemStaticBase* Gamespace::getItemAt(const Coord& pos) { return _occupancy.getItem(pos); }
 /**
  * getItemAt(Coord)
  * @brief Returns a pointer to an item located at a given tile.
@@ -273,34 +395,61 @@ ItemStaticBase* Gamespace::getItemAt(const Coord& pos)
  * @param posY				- The target tile's Y (vertical) index
  * @returns ItemStaticBase*	- nullptr if not found
  */
-ItemStaticBase* Gamespace::getItemAt(const int posX, const int posY)
-{
-	for ( auto* it : get_all_static_items() ) {
-		if ( posX == it->pos()._x && posY == it->pos()._y ) return it;
-	}
-	return nullptr;
-}
+ItemStaticBase* Gamespace::getItemAt(const int posX, const int posY) { return _occupancy.getItem(posX, posY); }
 /**
  * getPlayer()
  * @brief Returns a reference to the player instance.
  * @returns Player&
  */
 Player& Gamespace::getPlayer() { return _player; }
+/**
+ * getActors()
+ * @brief Returns a reference to the store that contains the components of every actor.
+ * @returns ActorStore&
+ */
+const ActorStore& Gamespace::getActors() const { return _actors; }
 /**
  * getTile(Coord&)
- * @brief Returns a reference to the tile at a given position.
- * @param pos		- Target coordinate in the tile matrix
- * @returns Tile&	- Reference of tile at pos, or __TILE_ERROR if an invalid coordinate was received.
+ * @brief Returns a copy of the tile at a given position.
+ * @param pos					- Target coordinate in the tile matrix
+ * @returns optional<Tile>	- Copy of the tile at pos, or std::nullopt if an invalid coordinate was received.
  */
-Tile* Gamespace::getTile(const Coord& pos) { return _world.get(pos); }
+std::optional<Tile> Gamespace::getTile(const Coord& pos) { return _world.get(pos); }
 /**
  * getTile(int, int)
- * @brief Returns a reference to the tile at a given position.
- * @param x			- Target X-axis coordinate in the tile matrix
- * @param y			- Target Y-axis coordinate in the tile matrix
- * @returns Tile&	- Reference of tile at pos, or __TILE_ERROR if an invalid coordinate was received.
+ * @brief Returns a copy of the tile at a given position.
+ * @param x						- Target X-axis coordinate in the tile matrix
+ * @param y						- Target Y-axis coordinate in the tile matrix
+ * @returns optional<Tile>	- Copy of the tile at pos, or std::nullopt if an invalid coordinate was received.
  */
-Tile* Gamespace::getTile(const int x, const int y) { return _world.get(x, y); }
+std::optional<Tile> Gamespace::getTile(const int x, const int y) { return _world.get(x, y); }
+/**
+ * setTile(Coord&, Tile::display)
+ * @brief Changes the type of a tile, and updates everything that depends on it: the cluster graph, the spawn pool, the NPCs that can see it, and the dirty list. \n
+ * This is the only way to change a tile once the gamespace exists.
+ * @param pos	- Target coordinate in the tile matrix
+ * @param as	- The new tile type
+ */
+void Gamespace::setTile(const Coord& pos, const Tile::display as)
+{
+	const auto version{ _world.moveVersion() };
+	_world.setDisplay(pos, as);
+	if ( _world.moveVersion() != version ) // only passability changes affect the cluster graph
+		_clusters.invalidate(pos);
+	refresh_spawn(pos);
+	stimulate(pos); // line of sight through this tile may have changed
+	_dirty.push_back(pos);
+}
+/**
+ * takeDirtyTiles(vector<Coord>&)
+ * @brief Retrieves the list of tiles whose visibility has changed since the last call, and clears it.
+ * @param out	- Receives the dirty list. Any existing elements are discarded.
+ */
+void Gamespace::takeDirtyTiles(std::vector<Coord>& out)
+{
+	out.clear();
+	std::swap(out, _dirty);
+}
 /**
  * getCell()
  * @brief Returns a reference to the attached cell
@@ -322,26 +471,6 @@ GameRules& Gamespace::getRuleset() const { return _ruleset; }
 #pragma endregion			GAME_GETTERS
 // Gamespace functions that apply passive effects to all actors, such as level-ups & stat regeneration.
 #pragma region GAME_PASSIVE_EFFECTS
-/**
- * regen(ActorBase*)
- * @brief Increases an actors stats by the relevant value in ruleset.
- * @param actor	- Pointer to an actor.
- */// ReSharper disable once CppMemberFunctionMayBeConst
-void Gamespace::regen(ActorBase* actor)
-{
-	if ( actor != nullptr && !actor->isDead() ) {
-		// If actor is not the player, regen double
-		if ( actor->faction() != FACTION::PLAYER ) {
-			actor->modHealth(_ruleset._regen_health * 2);
-			actor->modStamina(_ruleset._regen_stamina * 2);
-		}
-		else {
-			actor->modHealth(_ruleset._regen_health);
-			actor->modStamina(_ruleset._regen_stamina);
-		}
-	}
-}
-
 /**
  * regen(ActorBase*, int)
  * @brief Increases an actors stats by a percentage.
@@ -383,25 +512,42 @@ void Gamespace::level_up(ActorBase* a)
 
 /**
  * apply_level_ups()
- * @brief Applies pending level ups to all actors.
+ * @brief Applies pending level ups to all actors. \n
+ * Only actors whose kill count changed since the last pass can have become eligible, so only they are checked. An actor that is still eligible after leveling up is checked again during the next pass.
  */
-void Gamespace::apply_level_ups() { apply_to_all(&Gamespace::level_up); }
+void Gamespace::apply_level_ups()
+{
+	_level_checks.swap(_actors._kills_changed);
+	_actors._kills_changed.clear();
+	std::ranges::sort(_level_checks);
+	const auto [last, end] { std::ranges::unique(_level_checks) };
+	_level_checks.erase(last, end);
+	for ( const auto id : _level_checks ) {
+		if ( _actors._used[id] == 0u ) // removed since its last kill
+			continue;
+		auto* const actor{ _actors._owner[id] };
+		level_up(actor);
+		if ( _ruleset.canLevelUp(actor) ) // one level per pass
+			_actors._kills_changed.emplace_back(id);
+	}
+}
 
 /**
  * apply_passive()
- * @brief Applies passive regen effects to all actors. Amounts are determined by the ruleset.
+ * @brief Applies passive regen effects to all actors. Amounts are determined by the ruleset, NPCs regenerate double.
  */
-void Gamespace::apply_passive() { apply_to_all(&Gamespace::regen); }
+void Gamespace::apply_passive() { _actors.regenerate(_ruleset._regen_health, _ruleset._regen_stamina, 2); }
 
 #pragma endregion	GAME_PASSIVE_EFFECTS
 // Gamespace functions that move actors, or are related to moving actors.
 #pragma region GAME_MOVE_FUNCTIONS
 /**
- * getRandomDir()
+ * getRandomDir(CounterRNG&)
  * @brief Returns a random direction char
+ * @param rng		- The random number stream to draw from, usually the stream of the moving NPC.
  * @returns char	- w/a/s/d
  */
-char Gamespace::getRandomDir() { return _current_control_set->intToDir(_rng.get(3, 0)); }
+char Gamespace::getRandomDir(CounterRNG& rng) { return _current_control_set->intToDir(rng.get(3, 0)); }
 /**
  * canMove(Coord)
  * @brief Returns true if the target position can be moved to, and there is not an actor currently occupying it.
@@ -411,7 +557,7 @@ char Gamespace::getRandomDir() { return _current_control_set->intToDir(_rng.get(
 bool Gamespace::canMove(const Coord& pos)
 {
 	try {
-		return _world.isValidPos(pos) && _world.get(pos)->_canMove && getActorAt(pos) == nullptr;
+		return _world.canMove(pos) && getActorAt(pos) == nullptr;
 	} catch(...){}
 	return false;
 }
@@ -425,7 +571,7 @@ bool Gamespace::canMove(const Coord& pos)
 bool Gamespace::canMove(const int posX, const int posY)
 {
 	try {
-		return _world.isValidPos(posX, posY) && _world.get(posX, posY)->_canMove && getActorAt(posX, posY) == nullptr;
+		return _world.canMove(posX, posY) && getActorAt(posX, posY) == nullptr;
 	} catch(...){}
 	return false;
 }
@@ -439,7 +585,7 @@ bool Gamespace::canMove(const int posX, const int posY)
 bool Gamespace::checkMove(const Coord& pos, const FACTION myFac)
 {
 	try {
-		if (_world.get(pos)->_canMove) {
+		if (_world.canMove(pos)) {
 			// check pos for an actor
 			auto* target{ getActorAt(pos) };
 			// if there is no target, or if there is a target not of my faction
@@ -458,7 +604,7 @@ bool Gamespace::checkMove(const Coord& pos, const FACTION myFac)
 void Gamespace::trap(ActorBase* actor, const bool didMove)
 {
 	// If actor is standing on a trap, has moved this cycle, and is not a godmode-player
-	if ( _world.get(actor->pos())->_isTrap && didMove && !(actor->faction() == FACTION::PLAYER && _ruleset._player_godmode) ) {
+	if ( _world.isTrap(actor->pos()) && didMove && !(actor->faction() == FACTION::PLAYER && _ruleset._player_godmode) ) {
 		if ( _ruleset._trap_percentage ) // Remove a percentage of the actors health
 			actor->modHealth(-static_cast<int>(static_cast<float>(actor->getMaxHealth()) * (static_cast<float>(_ruleset._trap_dmg) / 100.0f)));
 		else // Remove a static value from the actors health
@@ -468,6 +614,42 @@ void Gamespace::trap(ActorBase* actor, const bool didMove)
 			actor->killedBy( _ruleset._killed_by_trap.at( _rng.get( static_cast<unsigned int>(_ruleset._killed_by_trap.size()) - 1u, 0u ) ) );
 	}
 }
+/**
+ * relocate_actor(ActorBase*, char)
+ * @brief Moves an actor one tile in the given direction with ActorBase::moveDir(), and updates the occupancy grid, spatial hash, & spawn pool. Does not check if the move is valid. \n
+ * When the player moves, every NPC that now belongs in the Near bucket is promoted.
+ * @param actor	- A pointer to the target actor
+ * @param dir	- A direction char from the controlset
+ */
+void Gamespace::relocate_actor(ActorBase* actor, const char dir)
+{
+	const auto from{ actor->pos() };
+	actor->moveDir(dir);
+	_occupancy.moveActor(actor, from, actor->pos());
+	_actor_hash.move(actor, from, actor->pos());
+	refresh_spawn(from);
+	refresh_spawn(actor->pos());
+	stimulate(from);
+	stimulate(actor->pos());
+	// NPCs the player walks up to are moved to the Near bucket at once, instead of when their next turn in a farther bucket comes up
+	if ( actor->faction() == FACTION::PLAYER )
+		_actor_hash.forEachObserver(actor->pos(), static_cast<int>(_max_vis), factionBit(FACTION::ENEMY) | factionBit(FACTION::NEUTRAL), [](ActorBase* observer) {
+			static_cast<NPC*>(observer)->promote();
+		}, static_cast<int>(_lod.nearRange()));
+}
+/**
+ * stimulate(Coord&)
+ * @brief Queues a perception stimulus for every NPC that can see a given position, so they look for targets again during their next turn. \n
+ * This must be called whenever something that NPCs perceive changes at a position: an actor arriving or leaving (relocate_actor(), removal & spawning), or a tile changing type (setTile()). \n
+ * Idle NPCs without a stimulus skip perception, so the cost of perception follows the number of events instead of the number of NPCs.
+ * @param pos	- The position of the event.
+ */
+void Gamespace::stimulate(const Coord& pos)
+{
+	_actor_hash.forEachObserver(pos, static_cast<int>(_max_vis), factionBit(FACTION::ENEMY) | factionBit(FACTION::NEUTRAL), [this](const ActorBase* observer) {
+		_actors._stimulus[observer->id()] = static_cast<unsigned char>(1u);
+	});
+}
 /**
  * move(ActorBase*, char)
  * @brief Attempts to move the target actor to an adjacent tile, and processes trap & item logic.
@@ -483,11 +665,11 @@ bool Gamespace::move(ActorBase* actor, const char dir)
 
 		// If the actor killed someone with an attack, move them to the target tile.
 		if ( target != nullptr && (attack(actor, target) == 1 && canMove(target->pos())) ) {  // NOLINT(bugprone-branch-clone)
-			actor->moveDir(dir);
+			relocate_actor(actor, dir);
 			did_move = true;
 		}
 		else if ( canMove(actor->getPosDir(dir)) ) {
-			actor->moveDir(dir);
+			relocate_actor(actor, dir);
 			did_move = true;
 		}
 		// Check for items
@@ -500,21 +682,104 @@ bool Gamespace::move(ActorBase* actor, const char dir)
 	}
 	return did_move;
 }
+/**
+ * dir_to(Coord&, Coord&)
+ * @brief Returns the direction char that moves from one tile to an orthogonally adjacent tile.
+ * @param from	 - The starting tile
+ * @param to	 - The adjacent target tile
+ * @returns char - A direction char from the controlset, or ' ' if the tiles aren't adjacent.
+ */
+char Gamespace::dir_to(const Coord& from, const Coord& to)
+{
+	if ( to._x == from._x && to._y == from._y - 1 ) return _current_control_set->_KEY_UP;
+	if ( to._x == from._x && to._y == from._y + 1 ) return _current_control_set->_KEY_DOWN;
+	if ( to._y == from._y && to._x == from._x - 1 ) return _current_control_set->_KEY_LEFT;
+	if ( to._y == from._y && to._x == from._x + 1 ) return _current_control_set->_KEY_RIGHT;
+	return ' ';
+}
+/**
+ * plan_path(NPC*, Coord&)
+ * @brief Fills an NPC's path cursor with a new path towards a goal. \n
+ * Goals within a few clusters are searched for directly, further goals are routed through the cluster graph & only the first segment is refined.
+ * @param npc		- Pointer to an NPC instance
+ * @param goal		- The goal position, usually the position of the NPC's target.
+ * @returns bool	- ( true = A path was found ) ( false = The goal is unreachable )
+ */
+bool Gamespace::plan_path(NPC* npc, const Coord& goal)
+{
+	auto& path{ npc->path() };
+	path._waypoints.clear();
+	const auto dx{ goal._x - npc->pos()._x }, dy{ goal._y - npc->pos()._y };
+	if ( ( dx < 0 ? -dx : dx ) + ( dy < 0 ? -dy : dy ) <= ClusterGraph::CLUSTER_SIZE * 2 )
+		return _pathfinder.find(_world.getMovePlane(), npc->pos(), goal, path._steps);
+	path._steps.clear();
+	return _clusters.find(npc->pos(), goal, path._waypoints) && refine_path(npc);
+}
+/**
+ * refine_path(NPC*)
+ * @brief Replaces the finished segment of an NPC's path with the steps to its next waypoint. If the waypoint can't be reached, the remaining waypoints are discarded.
+ * @param npc		- Pointer to an NPC instance
+ * @returns bool	- ( true = The next segment was refined ) ( false = There are no waypoints left, or the next one is unreachable )
+ */
+bool Gamespace::refine_path(NPC* npc)
+{
+	auto& path{ npc->path() };
+	while ( !path._waypoints.empty() && path._waypoints.back() == npc->pos() )
+		path._waypoints.pop_back();
+	if ( path._waypoints.empty() )
+		return false;
+	const auto next{ path._waypoints.back() };
+	path._waypoints.pop_back();
+	if ( _pathfinder.find(_world.getMovePlane(), npc->pos(), next, path._steps) )
+		return true;
+	path._waypoints.clear();
+	return false;
+}
 /**
  * moveNPC(NPC*, bool)
- * @brief Attempt to move an npc with obstacle avoidance towards its current target.
+ * @brief Attempt to move an npc with obstacle avoidance towards its current target. \n
+ * NPCs targeting the player follow the shared player flow field, which is only recalculated when the player changes tile. \n
+ * NPCs pursuing any other target follow an A* path, which is replanned every few steps or when the target moves away from the path's goal. \n
+ * Paths to distant targets are routed through the cluster graph, and only the segment up to the next waypoint is refined with A*. \n
+ * If no step is available, the greedy direction is used.
  * @param npc	 - Pointer to an NPC instance
  * @param noFear - NPC will never run away
  */
 bool Gamespace::moveNPC(NPC* npc, const bool noFear)
 {
+	if ( npc->getTarget() == &_player ) {
+		_player_flow.update(_world.getMovePlane(), _world.moveVersion(), _player.pos());
+		Coord steps[4];
+		// afraid NPCs follow the flee field instead
+		const auto count{ _player_flow.getSteps(npc->pos(), !noFear && npc->isAfraid(), steps) };
+		for ( size_t i{ 0u }; i < count; ++i )
+			if ( checkMove(steps[i], npc->faction()) )
+				return move(&*npc, dir_to(npc->pos(), steps[i]));
+	}
+	else if ( auto* target{ npc->getTarget() }; target != nullptr && ( noFear || !npc->isAfraid() ) ) {
+		auto& path{ npc->path() };
+		if ( !path.valid(npc->pos(), target->pos(), _world.moveVersion()) && path.canSearch() )
+			path.reset(target->pos(), _world.moveVersion(), plan_path(npc, target->pos()));
+		else if ( path.needsRefine() )
+			refine_path(npc);
+		if ( !path.empty() ) {
+			const auto next{ path.next() };
+			if ( checkMove(next, npc->faction()) ) {
+				const auto result{ move(&*npc, dir_to(npc->pos(), next)) };
+				if ( npc->pos() == next ) // the step isn't taken when moving into another actor attacks it
+					path.advance();
+				return result;
+			}
+			path.clear(); // blocked by an ally, replan next time
+		}
+	}
 	auto dir{ npc->getDirTo(noFear) };
 	const auto dirAsInt{ _current_control_set->dirToInt(dir) };
 	// if NPC can move in their chosen direction, return result of move
 	if ( checkMove(npc->getPosDir(dir), npc->faction()) )
 		return move(&*npc, dir);
 	// else find a new direction
-	switch ( _rng.get(1, 0) ) { // randomly choose order
+	switch ( npc->rng().get(1, 0) ) { // randomly choose order
 	case 0: // check adjacent tiles clockwise
 		for ( auto it{ dirAsInt - 1 }; it <= dirAsInt + 1; it += 2 ) {
 			// check if iterator is a valid direction int
@@ -610,6 +875,9 @@ int Gamespace::attack(ActorBase* attacker, ActorBase* target)
 			attacker->modHealth(-(dmg / 12));
 		}
 	}
+	// an attacked NPC must react during the next NPC cycle, however far it is from the player
+	if ( auto* const npc{ dynamic_cast<NPC*>(target) }; npc != nullptr )
+		npc->promote();
 	// POST-ATTACK CHECKS:
 	// if target died
 	if ( target->isDead() ) {
@@ -626,7 +894,10 @@ int Gamespace::attack(ActorBase* attacker, ActorBase* target)
 		target->addKill(attacker->getLevel() > target->getLevel() ? attacker->getLevel() - target->getLevel() : 1);
 		attacker->killedBy(target->name());
 	}
-	else target->setRelationship(attacker->faction(), true);
+	else {
+		target->setRelationship(attacker->faction(), true);
+		_actors._stimulus[target->id()] = static_cast<unsigned char>(1u); // the target may now be hostile to actors it could already see
+	}
 	if ( _ruleset._player_godmode && attacker->faction() == FACTION::PLAYER )
 		attacker->modStamina(_ruleset._attack_cost_stamina);
 	return target->isDead();
@@ -635,69 +906,155 @@ int Gamespace::attack(ActorBase* attacker, ActorBase* target)
 // Gamespace functions that perform actions for NPCs
 #pragma region GAME_ACTION_NPC
 /**
- * actionNPC(NPC*)
- * @brief Performs an action for a single NPC
- *
- * @param npc	 - Pointer to an NPC instance
- * @returns bool - ( true = NPC moved ) ( false = NPC did not move )
+ * canSee(NPC*, ActorBase*, Perception&, int)
+ * @brief Checks if an NPC has line of sight to a target actor, using a worker's own field of view calculator. \n
+ * This does not check the NPC's vision range by itself, call it after NPC::canSeeHostile() or NPC::canSeeTarget() so the cheaper radius check filters out distant targets first.
+ * @param npc		- Pointer to the viewing NPC
+ * @param target	- Pointer to the target actor
+ * @param scratch	- Scratch buffers owned by the calling worker
+ * @param visMod	- (Default: 0) Modifier added to the NPC's vision range
+ * @returns bool	- ( true = target is visible ) ( false = target is not visible, or is nullptr )
  */
-bool Gamespace::actionNPC(NPC* npc)
+bool Gamespace::canSee(NPC* npc, ActorBase* target, Perception& scratch, const int visMod) const
 {
-	auto rc{ false }; // return code
+	return target != nullptr && _world.canSee(npc->pos(), target->pos(), npc->getVis() + visMod, scratch._fov);
+}
+/**
+ * decide_npc(NPC*, Perception&)
+ * @brief Decides what a single NPC will do this tick, and updates its level-of-detail bucket. This is the intent phase of the NPC tick. \n
+ * Only the NPC's own target, aggression & bucket are modified, the rest of the gamespace is read-only, so many NPCs can decide at once from different threads.
+ * @param npc			- Pointer to an NPC instance
+ * @param scratch		- Scratch buffers owned by the calling worker
+ * @returns NPCIntent	- The action to apply during the commit phase.
+ */
+Gamespace::NPCIntent Gamespace::decide_npc(NPC* npc, Perception& scratch)
+{
+	const auto intent{ decide_action(npc, scratch) };
+	// the bucket is chosen after deciding, so an NPC that just acquired a target is kept in the Near bucket
+	npc->setLOD(_lod.classify(npc->pos(), _player.pos(), npc->getVis(), npc->hasTarget() || npc->isAggro()));
+	return intent;
+}
+/**
+ * decide_action(NPC*, Perception&)
+ * @brief Chooses the action of a single NPC, and updates its target & aggression. Called by decide_npc().
+ * @param npc			- Pointer to an NPC instance
+ * @param scratch		- Scratch buffers owned by the calling worker
+ * @returns NPCIntent	- The action to apply during the commit phase.
+ */
+Gamespace::NPCIntent Gamespace::decide_action(NPC* npc, Perception& scratch)
+{
+	if ( npc->isDead() )
+		return { npc };
 	// Finale Challenge Event - enemies always attack player, neutrals attack player if ruleset allows it
 	if ( _game_state._final_challenge.load() && (npc->faction() == FACTION::ENEMY || npc->faction() == FACTION::NEUTRAL && _ruleset._challenge_neutral_is_hostile) ) {
 		if ( !npc->isAggro() || npc->getTarget() != &_player ) // during the final challenge event, force all hostiles to be aggravated against the player.
 			npc->setTargetMaxAggro(&_player);
-		rc = moveNPC(&*npc, true);
+		return { npc, NPCIntent::Action::PURSUE, true };
 	}
-	else { // Normal turn
-		// if the npc is hostile to player, and can see them, switch targets
-		if ( npc->canSeeHostile(&_player) ) {
-			//npc->setTarget(&_player);
-			if ( npc->setTargetMaxAggro(&_player) )
-				rc = moveNPC(&*npc);
-		}
-		// npc is aggravated
-		else if ( npc->isAggro() ) {
-			//if ( _rng.get(100.0f, 0.0f) < _ruleset._npc_move_chance_aggro )	{
-				// if the NPC has a target, move to it, else remove aggression
-				if ( npc->hasTarget() )
-					rc = moveNPC(&*npc);
-				else npc->removeAggro();
-				// If the NPC can still see their target, set aggression to max and continue following
-				if ( npc->canSeeTarget(_ruleset._npc_vis_mod_aggro) )
-					npc->maxAggro();
-				else
-					npc->decrementAggro();
-		//	}
-		}
-		// npc is idle, check nearby
-		else {
-			// get a pointer to the nearest actor
-			auto* const nearest{ getClosestActor(npc->pos(), npc->getVis()) };
-			if ( nearest != nullptr && npc->canSeeHostile(&*nearest) ) {
-				//	npc->setTarget(&*nearest);
-					if ( npc->setTargetMaxAggro(&*nearest) )
-						rc = moveNPC(&*npc);
-				//else if ( _rng.get(_ruleset._npc_move_chance, 0.0f) < 1.0f )
-				//	rc = move(&*npc, getRandomDir());
-			}
-			else if ( _rng.get(100.0f, 0.0f) < _ruleset._npc_move_chance )
-				rc = move(&*npc, getRandomDir());
-			// else do nothing
-		}
+	// Normal turn
+	// an idle NPC only looks for targets when something changed within its sight since the last time it looked & saw nothing
+	if ( !npc->isAggro() && npc->getTarget() == nullptr && _actors._stimulus[npc->id()] == 0u )
+		return { npc, NPCIntent::Action::WANDER };
+	// if the npc is hostile to player, and can see them, switch targets
+	if ( npc->canSeeHostile(&_player) && canSee(npc, &_player, scratch) )
+		return { npc, npc->setTargetMaxAggro(&_player) ? NPCIntent::Action::PURSUE : NPCIntent::Action::NONE };
+	// npc is aggravated
+	if ( npc->isAggro() ) {
+		_actors._stimulus[npc->id()] = static_cast<unsigned char>(1u); // look around once the NPC calms down
+		auto action{ NPCIntent::Action::NONE };
+		// if the NPC has a target, move to it, else remove aggression
+		if ( npc->hasTarget() )
+			action = NPCIntent::Action::PURSUE;
+		else npc->removeAggro();
+		// If the NPC can still see their target, set aggression to max and continue following
+		if ( npc->canSeeTarget(_ruleset._npc_vis_mod_aggro) && canSee(npc, npc->getTarget(), scratch, _ruleset._npc_vis_mod_aggro) )
+			npc->maxAggro();
+		else
+			npc->decrementAggro();
+		return { npc, action };
+	}
+	// npc is idle, get the nearest few actors this npc is hostile to, and target the closest one it has line of sight to
+	_actor_hash.nearest(npc->pos(), npc->getVis(), 3u, npc->hostileMask(), scratch._nearby, npc, scratch._ranking);
+	const auto it{ std::ranges::find_if(scratch._nearby, [this, npc, &scratch](ActorBase* a) { return npc->canSeeHostile(a) && canSee(npc, a, scratch); }) };
+	if ( it != scratch._nearby.end() )
+		return { npc, npc->setTargetMaxAggro(&**it) ? NPCIntent::Action::PURSUE : NPCIntent::Action::NONE };
+	_actors._stimulus[npc->id()] = static_cast<unsigned char>(0u); // nothing in sight, wait for something to change
+	return { npc, NPCIntent::Action::WANDER };
+}
+/**
+ * decide_range(size_t, size_t, Perception&)
+ * @brief Runs the intent phase for a contiguous range of the intent list.
+ * @param first		- Index of the first intent.
+ * @param last		- Index one past the last intent.
+ * @param scratch	- Scratch buffers owned by the calling worker
+ */
+void Gamespace::decide_range(const size_t first, const size_t last, Perception& scratch)
+{
+	for ( auto i{ first }; i < last; ++i )
+		_intents[i] = decide_npc(_intents[i]._npc, scratch);
+}
+/**
+ * commit_npc(NPCIntent&)
+ * @brief Applies an NPC's intent. This is the commit phase of the NPC tick, and must be called from one thread, in a fixed order. \n
+ * Conflicts are resolved by the order of the calls: an NPC moving into a tile taken earlier in the same tick tries another direction instead.
+ * @param intent	- The intent returned by decide_npc()
+ * @returns bool	- ( true = NPC moved ) ( false = NPC did not move )
+ */
+bool Gamespace::commit_npc(const NPCIntent& intent)
+{
+	auto* const npc{ intent._npc };
+	if ( npc->isDead() ) // killed by an NPC that acted earlier this tick
+		return false;
+	switch ( intent._action ) {
+	case NPCIntent::Action::PURSUE: // the target may have been killed earlier this tick
+		if ( !npc->hasTarget() )
+			return false;
+		// an NPC that is being pursued must react during the next NPC cycle
+		if ( auto* const target{ dynamic_cast<NPC*>(npc->getTarget()) }; target != nullptr )
+			target->promote();
+		return moveNPC(npc, intent._no_fear);
+	case NPCIntent::Action::WANDER:
+		return npc->rng().get(100.0f, 0.0f) < _ruleset._npc_move_chance && move(npc, getRandomDir(npc->rng()));
+	default:
+		return false;
 	}
-	return rc;
 }
-
+/**
+ * attachJobs(JobSystem*)
+ * @brief Sets the thread pool used to spread work across cores.
+ * @param jobs	- Pointer to a job system that outlives its use by the gamespace, or nullptr to run everything on the calling thread.
+ */
+void Gamespace::attachJobs(JobSystem* jobs) { _jobs = jobs; }
 /**
  * actionAllNPC()
- * @brief Performs an action for all NPC instances
+ * @brief Performs an action for every NPC instance that is due this cycle, as decided by the LOD scheduler. \n
+ * Every acting NPC first decides what to do from the state of the gamespace at the start of the tick, split into batches across the attached job system. \n
+ * The decisions are then applied one at a time in a fixed order, so the result doesn't depend on thread timing.
  */
 void Gamespace::actionAllNPC()
 {
-	// Perform all NPC actions.
-	apply_to_npc(&Gamespace::actionNPC);
+	// only NPCs that are due this cycle act, NPCs far from the player are skipped on most cycles
+	_lod.nextCycle();
+	_intents.clear();
+	// the phase is the entity id, which unlike the position in the vectors doesn't change when another NPC is removed
+	for ( auto& it : _hostile )
+		if ( _lod.due(it.lod(), it.id()) )
+			_intents.push_back({ &it });
+	for ( auto& it : _neutral )
+		if ( _lod.due(it.lod(), it.id()) )
+			_intents.push_back({ &it });
+
+	// intent phase, each batch uses the scratch buffers matching its batch index
+	if ( const auto workers{ _jobs != nullptr ? _jobs->concurrency() : 1u }; _perception.size() < workers )
+		_perception.resize(workers);
+	if ( _jobs != nullptr )
+		_jobs->parallel_for(_intents.size(), NPC_BATCH_MIN, [this](const size_t batch, const size_t first, const size_t last) { decide_range(first, last, _perception[batch]); });
+	else
+		decide_range(0u, _intents.size(), _perception.front());
+
+	// commit phase
+	for ( const auto& intent : _intents )
+		commit_npc(intent);
 }
 #pragma endregion			GAME_ACTION_NPC
 // Gamespace functions that perform actions for the player.
@@ -712,11 +1069,22 @@ void Gamespace::actionPlayer(const char key)
 {
 	// if not dead and move was successful
 	if ( !_player.isDead() && move(&_player, key) ) {
-		if ( _ruleset._dark_mode ) _world.modVis(false);
 		// player specific post-movement functions
-		_world.modVisCircle(true, _player.pos(), _player.getVis() + 2); // allow the player to see the area around them
+		update_reveal();
 	}
 }
+/**
+ * update_reveal()
+ * @brief Reveals the area around the player. \n
+ * Only tiles entering the player's vision are revealed, and in dark mode only tiles leaving it are hidden, instead of resetting the whole cell. \n
+ * Every tile that changed is added to the dirty list, see takeDirtyTiles().
+ */
+void Gamespace::update_reveal()
+{
+	_reveal_next = _world.getFOV(_player.pos(), _player.getVis() + 2); // allow the player to see the area around them
+	_world.modVisDelta(_reveal, _reveal_next, _ruleset._dark_mode, _dirty);
+	std::swap(_reveal, _reveal_next);
+}
 #pragma endregion		GAME_ACTION_PLAYER
 // Gamespace functions related to cleaning up expired game elements.
 #pragma region GAME_CLEANUP
@@ -758,31 +1126,30 @@ void Gamespace::update_state() noexcept
 }
 /**
  * cleanupDead()
- * @brief Cleans up expired game elements. This should be called approx. once per draw cycle.
+ * @brief Cleans up expired game elements. This is called at the end of every tick by finishTick().
  */
 void Gamespace::cleanupDead() noexcept
 {
 	try {
-		// erase dead enemies
-		for ( auto it{static_cast<signed>(_hostile.size()) - 1}; it >= 0; --it )
-			if ( _hostile.at(it).isDead() )
-				_hostile.erase(_hostile.begin() + it);
-		// erase dead neutrals
-		for ( auto it{static_cast<signed>(_neutral.size() - 1)}; it >= 0; --it )
-			if ( _neutral.at(it).isDead() )
-				_neutral.erase(_neutral.begin() + it);
-		// Erase used health potions
-		for ( auto it{static_cast<signed>(_item_static_health.size() - 1)}; it >= 0; --it )
-			if ( _item_static_health.at(it).getUses() <= 0 )
-				_item_static_health.erase(_item_static_health.begin() + it);
-		// Erase used stamina potions
-		for ( auto it{static_cast<signed>(_item_static_stamina.size() - 1)}; it >= 0; --it )
-			if ( _item_static_stamina.at(it).getUses() <= 0 )
-				_item_static_stamina.erase(_item_static_stamina.begin() + it);
+		remove_expired(_hostile);
+		remove_expired(_neutral);
+		remove_expired(_item_static_health);
+		remove_expired(_item_static_stamina);
 		update_state();
 	}
 	catch ( ... ) {}
 }
+
+/**
+ * finishTick()
+ * @brief Ends the current simulation tick by cleaning up expired game elements, advancing the active flare, and incrementing the tick number.
+ */
+void Gamespace::finishTick()
+{
+	cleanupDead();
+	updateFlare();
+	++_game_state._tick;
+}
 #pragma endregion			GAME_CLEANUP
 // Gamespace functions related to FrameBuffer color flares.
 #pragma region GAME_FLARE
@@ -817,4 +1184,17 @@ void Gamespace::resetFlare()
 		_FLARE_QUEUE.erase(_FLARE_QUEUE.begin());
 	} // else do nothing
 }
+
+/**
+ * updateFlare()
+ * @brief Advances the currently set flare by one tick, and resets it once its time has run out.
+ */
+void Gamespace::updateFlare()
+{
+	if ( auto* const flare{ getFlare() }; flare != nullptr ) {
+		if ( flare->time() > 1 )
+			flare->decrement();
+		else resetFlare();
+	}
+}
 #pragma endregion				GAME_FLARE
\ No newline at end of file
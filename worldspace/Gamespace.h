@@ -5,27 +5,99 @@
  * @author radj307
  */
 #pragma once
+#include <random>
+
 #include "actor.h"
 #include "cell.h"
 #include "Flare.h"
 #include "GameRules.h"
 #include "GameState.h"
 #include "item.h"
+#include "jobsystem.h"
+#include "lod.h"
+#include "rng.h"
+#include "clustergraph.h"
+#include "flowfield.h"
+#include "pathfinder.h"
+#include "occupancy.h"
+#include "spatialhash.h"
+#include "spawnpool.h"
 
 /**
  * @class Gamespace
  * @brief Contains all of the game-related functions required for running a game. Does not contain any display functions, use external FrameBuffer.
  */
 class Gamespace final {
+	/**
+	 * @struct NPCIntent
+	 * @brief The action an NPC decided to take during the intent phase of a tick, which is applied during the commit phase.
+	 */
+	struct NPCIntent final {
+		enum class Action : char {
+			NONE,	///< @brief Do nothing this tick.
+			PURSUE,	///< @brief Move towards (or away from) the NPC's target, attacking it if it is adjacent.
+			WANDER,	///< @brief Randomly move in a random direction, depending on the ruleset's move chance.
+		};
+		NPC* _npc;					///< @brief The NPC that made the decision.
+		Action _action{ Action::NONE };	///< @brief The chosen action.
+		bool _no_fear{ false };		///< @brief When true, the NPC pursues its target even if it is afraid.
+	};
+	/**
+	 * @struct Perception
+	 * @brief Scratch buffers owned by a single worker during the intent phase, so that workers never share mutable state.
+	 */
+	struct Perception final {
+		FieldOfView _fov;				///< @brief Field of view calculator & cache, used instead of the cell's own.
+		std::vector<ActorBase*> _nearby;	///< @brief Results of spatial hash queries.
+		SpatialHash::Ranking _ranking;	///< @brief Scratch buffer for spatial hash queries.
+	};
+	// The minimum number of NPCs given to each worker during the intent phase, below this the thread overhead outweighs the work.
+	static constexpr size_t NPC_BATCH_MIN{ 32u };
+
+	// Stream ids reserved by the gamespace, entity streams are numbered after these.
+	enum STREAM : std::uint64_t { WORLD = 0, GAMESPACE = 1, FIRST_ENTITY = 2 };
+
 	// Reference to the game's ruleset
 	GameRules& _ruleset;
+	// World seed that every random number stream is derived from
+	const std::uint64_t _seed;
+	// The stream id given to the next entity
+	std::uint64_t _next_stream{ FIRST_ENTITY };
 	// worldspace cell
 	Cell _world;
-	// Randomization engine
-	tRand _rng;
+	// Per-tile actor & item index, must be declared before any actors.
+	OccupancyGrid _occupancy;
+	// The largest vision range of any actor, used as the spatial hash bucket size & the range of perception events.
+	long _max_vis;
+	// Per-faction actor buckets used for range queries, must be declared before any actors.
+	SpatialHash _actor_hash;
+	// Tiles that entities can currently spawn on, must be declared before any actors.
+	SpawnPool _spawn_pool;
+	// Distance field towards the player, shared by every NPC pursuing or fleeing from the player
+	FlowField _player_flow;
+	// A* search used by NPCs pursuing any target other than the player
+	Pathfinder _pathfinder;
+	// Abstract graph used to route NPCs towards distant targets before refining the route with _pathfinder
+	ClusterGraph _clusters;
+	// Scratch buffer for spatial hash queries
+	std::vector<ActorBase*> _nearby;
+	// Thread pool used to spread work across cores, or nullptr to run everything on the calling thread
+	JobSystem* _jobs{ nullptr };
+	// Decides which NPCs act during each NPC cycle, based on their distance from the player
+	LODScheduler _lod;
+	// Intents of every NPC for the current tick, in commit order
+	std::vector<NPCIntent> _intents;
+	// Per-worker scratch buffers for the intent phase
+	std::vector<Perception> _perception;
+	// Random number stream used by the gamespace itself, NPCs use their own stream
+	CounterRNG _rng;
 	// Functor for checking distance between 2 points
 	checkDistance getDist;
 
+	// components of every actor, must be declared before any actors.
+	ActorStore _actors;
+	// Scratch buffer of the ids checked by apply_level_ups()
+	std::vector<EntityId> _level_checks;
 	// player character
 	Player _player;
 	// generic enemies
@@ -38,6 +110,13 @@ class Gamespace final {
 	// Static Items - Stamina
 	std::vector<ItemStaticStamina> _item_static_stamina;
 
+	// The area currently revealed by the player's vision
+	SpanList _reveal;
+	// Scratch buffer used when calculating the next revealed area
+	SpanList _reveal_next;
+	// Tiles whose visibility or type changed since the last call to takeDirtyTiles()
+	std::vector<Coord> _dirty;
+
 	// Declare Flare instances
 	std::vector<Flare*> _FLARE_QUEUE{};
 	FlareLevel _FLARE_DEF_LEVEL;			// Flare used when the player levels up
@@ -45,28 +124,44 @@ class Gamespace final {
 	FlareBoss _FLARE_DEF_BOSS;
 
 	void addFlare(Flare& newFlare);
-	[[nodiscard]] Coord findValidSpawn(bool isPlayer = false, bool checkForItems = true);
+	[[nodiscard]] static SpawnPool build_spawn_pool(Cell& cell);
+	void refresh_spawn(const Coord& pos);
+	[[nodiscard]] Coord findValidSpawn(bool isPlayer = false);
 	template<typename Actor> [[nodiscard]] std::vector<Actor> generate_NPCs(int count, std::vector<ActorTemplate>& templates);
 	template<typename Item> [[nodiscard]] std::vector<Item> generate_items(int count, bool lockToPlayer = false);
 	template<typename NPC> [[nodiscard]] NPC build_npc(ActorTemplate& actorTemplate);
 	template<typename NPC> [[nodiscard]] NPC build_npc(const Coord& pos, ActorTemplate& actorTemplate);
 	void spawn_boss();
+	template<typename T> void index_all(std::vector<T>& vec, size_t first = 0u);
+	template<typename T> void remove_expired(std::vector<T>& vec);
+	void relocate_actor(ActorBase* actor, char dir);
+	void stimulate(const Coord& pos);
+	void update_reveal();
+	void rehash_actors();
+	[[nodiscard]] static long max_vis_range(const GameRules& ruleset);
 	void update_state() noexcept;
 	void apply_to_all(void (Gamespace::*func)(ActorBase*));
 	void apply_to_npc(void (Gamespace::*func)(NPC*));
 	void apply_to_npc(bool (Gamespace::*func)(NPC*));
-	void regen(ActorBase* actor);
 	static void regen(ActorBase* actor, int percent);
 	void level_up(ActorBase* a);
-	[[nodiscard]] char getRandomDir();
+	[[nodiscard]] char getRandomDir(CounterRNG& rng);
+	[[nodiscard]] CounterRNG next_stream();
 	[[nodiscard]] bool canMove(const Coord& pos);
 	[[nodiscard]] bool canMove(int posX, int posY);
 	[[nodiscard]] bool checkMove(const Coord& pos, FACTION myFac);
 	void trap(ActorBase* actor, bool didMove);
 	[[nodiscard]] bool move(ActorBase* actor, char dir);
+	[[nodiscard]] static char dir_to(const Coord& from, const Coord& to);
+	[[nodiscard]] bool plan_path(NPC* npc, const Coord& goal);
+	bool refine_path(NPC* npc);
 	[[nodiscard]] bool moveNPC(NPC* npc, bool noFear = false);
 	int attack(ActorBase* attacker, ActorBase* target);
-	bool actionNPC(NPC* npc);
+	[[nodiscard]] bool canSee(NPC* npc, ActorBase* target, Perception& scratch, int visMod = 0) const;
+	[[nodiscard]] NPCIntent decide_npc(NPC* npc, Perception& scratch);
+	[[nodiscard]] NPCIntent decide_action(NPC* npc, Perception& scratch);
+	void decide_range(size_t first, size_t last, Perception& scratch);
+	bool commit_npc(const NPCIntent& intent);
 	[[nodiscard]] constexpr bool trigger_final_challenge(const unsigned int remainingEnemies) const { return remainingEnemies <= _ruleset._enemy_count * _ruleset._challenge_final_trigger_percent / 100; }
 
 public:
@@ -76,6 +171,21 @@ public:
 	[[nodiscard]] std::vector<ActorBase*> get_all_actors();
 	[[nodiscard]] std::vector<NPC*> get_all_npc();
 	[[nodiscard]] std::vector<ItemStaticBase*> get_all_static_items();
+	/**
+	 * forEachStaticItem(Func&&)
+	 * @brief Calls a function for every static item in the game, health items first. Unlike get_all_static_items(), this doesn't allocate.
+	 * @tparam Func	- Function type, with the signature void(const ItemStaticBase&)
+	 * @param func	- The function to call
+	 */
+	template<typename Func>
+	void forEachStaticItem(Func&& func) const
+	{
+		for ( const auto& it : _item_static_health )
+			func(static_cast<const ItemStaticBase&>(it));
+		for ( const auto& it : _item_static_stamina )
+			func(static_cast<const ItemStaticBase&>(it));
+	}
+	void attachJobs(JobSystem* jobs);
 	void actionAllNPC();
 	void actionPlayer(char key);
 	void apply_level_ups();
@@ -87,13 +197,18 @@ public:
 	[[nodiscard]] ItemStaticBase* getItemAt(const Coord& pos);
 	[[nodiscard]] ItemStaticBase* getItemAt(int posX, int posY);
 	[[nodiscard]] Player& getPlayer();
-	[[nodiscard]] Tile* getTile(const Coord& pos);
-	[[nodiscard]] Tile* getTile(int x, int y);
+	[[nodiscard]] const ActorStore& getActors() const;
+	[[nodiscard]] std::optional<Tile> getTile(const Coord& pos);
+	[[nodiscard]] std::optional<Tile> getTile(int x, int y);
+	void setTile(const Coord& pos, Tile::display as);
 	[[nodiscard]] Cell& getCell();
 	[[nodiscard]] Coord getCellSize() const;
 	[[nodiscard]] GameRules& getRuleset() const;
 	[[nodiscard]] Flare* getFlare() const;
 	void resetFlare();
+	void updateFlare();
+	void finishTick();
+	void takeDirtyTiles(std::vector<Coord>& out);
 
 	// Contains information about the game outcome.
 	GameState _game_state;
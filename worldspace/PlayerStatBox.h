@@ -9,14 +9,40 @@
 
 #include "actor.h"
 #include "Coord.h"
+#include "terminal.h"
+/**
+ * @struct PlayerStats
+ * @brief A copy of the player stats shown by the PlayerStatBox, so they can be displayed without reading the gamespace.
+ */
+struct PlayerStats final {
+	std::string _name;
+	int _level{ 0 }, _health{ 0 }, _max_health{ 0 }, _stamina{ 0 }, _max_stamina{ 0 }, _kills{ 0 };
+
+	/**
+	 * assign(Player&)
+	 * @brief Copies the current stats of the player.
+	 * @param player	- The player
+	 */
+	void assign( const Player& player )
+	{
+		_name = player.name();
+		_level = player.getLevel();
+		_health = player.getHealth();
+		_max_health = player.getMaxHealth();
+		_stamina = player.getStamina();
+		_max_stamina = player.getMaxStamina();
+		_kills = player.getKills();
+	}
+
+	bool operator==( const PlayerStats& ) const = default;
+};
+
 /**
  * @struct PlayerStatBox
  * @brief Object used to display player stats.
  */
 struct PlayerStatBox final {
 private:
-	std::string _pName;
-	int *_pKills{ nullptr }, *_pLevel{ nullptr }, *_pHealth{ nullptr }, *_pMaxHealth{ nullptr }, *_pStamina{ nullptr }, *_pMaxStamina{ nullptr };
 	const bool _SHOW_VALUES;
 	const long _MAX_LINE_LENGTH, _LINE_COUNT;
 	Coord _origin, _max; // top-left & bottom-right corners
@@ -24,7 +50,7 @@ private:
 
 public:
 	/**
-	 * PlayerStatBox(Player*, bool)
+	 * PlayerStatBox(Coord, bool, tuple<char, char, char>)
 	 * @brief Default Constructor
 	 *
 	 *	\<name\> Stats Level \<level\>
@@ -32,12 +58,11 @@ public:
 	 *	\<health val\>  \<stamina val\>
 	 *		  Kills: \<kills\>
 	 *
-	 * @param playerPtr		- Pointer to the player
 	 * @param center_top	- The top-center point of the box
 	 * @param chars			- Characters used for stat bars. { \<open bracket\>, \<fill char\>, \<close bracket\> }
 	 * @param showValues	- (Default: false) When true, values are displayed below the stat bars.
 	 */
-	explicit PlayerStatBox( Player* playerPtr, const Coord center_top, const bool showValues = false, std::tuple<char, char, char> chars = { '[', '@', ']' } ) : _pName( playerPtr->name() ), _pKills( playerPtr->ptrKills() ), _pLevel( playerPtr->ptrLevel() ), _pHealth( playerPtr->ptrHealth() ), _pMaxHealth( playerPtr->ptrMaxHealth() ), _pStamina( playerPtr->ptrStamina() ), _pMaxStamina( playerPtr->ptrMaxStamina() ), _SHOW_VALUES( showValues ), _MAX_LINE_LENGTH( 28 ), _LINE_COUNT( 3 + showValues ), _origin( center_top._x + 3 - _MAX_LINE_LENGTH / 2, center_top._y ), _max( _origin._x + _MAX_LINE_LENGTH, _origin._y + _LINE_COUNT ), _CH_BAR( std::move( chars ) )
+	explicit PlayerStatBox( const Coord center_top, const bool showValues = false, std::tuple<char, char, char> chars = { '[', '@', ']' } ) : _SHOW_VALUES( showValues ), _MAX_LINE_LENGTH( 28 ), _LINE_COUNT( 3 + showValues ), _origin( center_top._x + 3 - _MAX_LINE_LENGTH / 2, center_top._y ), _max( _origin._x + _MAX_LINE_LENGTH, _origin._y + _LINE_COUNT ), _CH_BAR( std::move( chars ) )
 	{
 	}
 
@@ -55,38 +80,48 @@ public:
 	[[nodiscard]] unsigned int height() const { return _LINE_COUNT; }
 
 	/**
-	 * display()
+	 * below()
+	 * @brief Returns the position of the first line below the player stat box, aligned with its left edge.
+	 * @returns Coord
+	 */
+	[[nodiscard]] Coord below() const { return { _origin._x, _max._y }; }
+
+	/**
+	 * display(Terminal&, PlayerStats&)
 	 * @brief Displays the player stat box at the origin point set in constructor
+	 * @param out		- The terminal buffer to draw to, this is not flushed.
+	 * @param player	- The player stats to display.
 	 */
-	void display() const
+	void display( Terminal& out, const PlayerStats& player ) const
 	{
-		// Simply turns an int* to a string
-		const auto str( []( const int* integer ) -> std::string { return std::to_string( *integer ); } );
+		// Simply turns an int to a string
+		const auto str( []( const int integer ) -> std::string { return std::to_string( integer ); } );
 		const auto getStatBar(
-			[]( const int* max, const int* val, const char fillCh = '@' ) -> std::string {
+			[]( const int max, const int val, const char fillCh = '@' ) -> std::string {
 				std::string r{ "" };
-				const auto seg{ *max / 10 };
+				const auto seg{ max / 10 };
 				for ( auto i{ 1 }; i <= 10; ++i )
-					r += *val >= i * seg ? fillCh : ' ';
+					r += val >= i * seg ? fillCh : ' ';
 				return r;
 			} );
-		sys::cursorPos( _origin ); // Set cursor pos
-		std::cout << str::align_center( { _pName + " Stats Level " + str( _pLevel ) }, _MAX_LINE_LENGTH );
-		sys::cursorPos( _origin._x, _origin._y + 1 );
-		printf("(");
-		sys::colorSet(Color::_f_red);
-		printf("%s", getStatBar(_pMaxHealth, _pHealth).c_str());
-		sys::colorReset();
-		printf(")  (");
-		sys::colorSet(Color::_f_green);
-		printf("%s", getStatBar(_pMaxStamina, _pStamina).c_str());
-		sys::colorReset();
-		printf(")");
-		sys::cursorPos( _origin._x, _origin._y + 2 );
+		out.reset(); // the terminal may still be in the color of the last tile drawn
+		out.moveTo( _origin._x, _origin._y ); // Set cursor pos
+		out.put( str::align_center( { player._name + " Stats Level " + str( player._level ) }, _MAX_LINE_LENGTH ) );
+		out.moveTo( _origin._x, _origin._y + 1 );
+		out.put( '(' );
+		out.color( Color::_f_red );
+		out.put( getStatBar( player._max_health, player._health ) );
+		out.reset();
+		out.put( ")  (" );
+		out.color( Color::_f_green );
+		out.put( getStatBar( player._max_stamina, player._stamina ) );
+		out.reset();
+		out.put( ')' );
+		out.moveTo( _origin._x, _origin._y + 2 );
 		if ( _SHOW_VALUES ) {
-			std::cout << str::align_center( { "Health: " + str( _pHealth ) + "  Stamina: " + str( _pStamina ) }, _MAX_LINE_LENGTH );
-			sys::cursorPos( _origin._x, _origin._y + 3 );
+			out.put( str::align_center( { "Health: " + str( player._health ) + "  Stamina: " + str( player._stamina ) }, _MAX_LINE_LENGTH ) );
+			out.moveTo( _origin._x, _origin._y + 3 );
 		}
-		std::cout << str::align_center( { "Kills: " + str( _pKills ) }, _MAX_LINE_LENGTH );
+		out.put( str::align_center( { "Kills: " + str( player._kills ) }, _MAX_LINE_LENGTH ) );
 	}
 };
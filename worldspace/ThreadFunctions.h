@@ -1,16 +1,18 @@
 /**
  * @file ThreadFunctions.h
  * @author radj307
- * @brief Contains main functions for multithreads from the game namespace. \n
- * Used in game_threads.hpp
+ * @brief Contains the fixed-timestep game loop & the tasks it submits to the job system, from the game namespace. \n
+ * Used in game.hpp
  */
 #pragma once
 #pragma region THREAD_FUNC
 #include <conio.h>
-#include <mutex>
+#include <stop_token>
+#include <thread>
 
 #include "FrameBuffer.h"
 #include "Gamespace.h"
+#include "jobsystem.h"
 #include "shared.h"
 
 /**
@@ -21,107 +23,211 @@ namespace game::_internal {
 	using CLK = std::chrono::high_resolution_clock; ///< Game timer clock
 
 	/**
-	 * game_thread_player(Gamespace&, GLOBAL&)
-	 * @brief Thread function that receives & processes player key presses independantly of the display/npc threads.
-	 * @param mutx	- Shared Mutex
+	 * task_player(memory&, Gamespace&)
+	 * @brief Task that processes every pending player key press. Returns immediately if no key was pressed.
 	 * @param mem	- Shared Memory
-	 * @param game	- Reference to the associated gamespace, passed with std::ref()
+	 * @param game	- Reference to the associated gamespace
 	 */
-	inline void thread_player( std::mutex& mutx, memory& mem, Gamespace& game )
+	inline void task_player( memory& mem, Gamespace& game )
 	{
-		while ( !mem._kill.load() ) {
-			// getch waits until key press, no need to sleep this thread.
-			if ( _kbhit() ) {
-				const auto key{ static_cast<char>(std::tolower( _getch() )) };
-				// if game is not paused
-				if ( !mem._pause.load() ) {
-					// switch player keypress
-					switch ( key ) {
-					case 'q': // player pressed the exit game key
-						mem._kill_code.store( PLAYER_QUIT_CODE );
-						game._game_state._game_is_over.store( true );
-						mem._kill.store( true );
-						return;
-					case 'p': // player pressed the pause game key
-						mem._pause.store( true );
-						break;
-					default: // player pressed a different key, process it
-						std::scoped_lock<std::mutex> game_lock( mutx ); // lock the mutex
-						game.actionPlayer( key );
-						break;
-					}
-				} // else check if player wants to unpause
-				else if ( key == 'p' ) 
-					mem.unpause_game();
-			}
-			else std::this_thread::sleep_for( __FRAMETIME );
+		while ( _kbhit() ) {
+			const auto key{ static_cast<char>(std::tolower( _getch() )) };
+			// if game is not paused
+			if ( !mem._pause.load() ) {
+				// switch player keypress
+				switch ( key ) {
+				case 'q': // player pressed the exit game key
+					mem._kill_code.store( PLAYER_QUIT_CODE );
+					game._game_state._game_is_over.store( true );
+					mem._kill.store( true );
+					return;
+				case 'p': // player pressed the pause game key
+					mem.pause_game();
+					return;
+				default: // player pressed a different key, process it
+					game.actionPlayer( key );
+					break;
+				}
+			} // else check if player wants to unpause
+			else if ( key == 'p' )
+				mem.unpause_game();
 		}
 	}
 
 	/**
-	 * game_thread_npc(Gamespace&)
-	 * @brief Thread function that controls the NPC actors.
-	 * @param mutx	- Shared Mutex
+	 * check_game_over(memory&, Gamespace&)
+	 * @brief Sets the kill flag & code if the game is over.
+	 * @param mem		- Shared Memory
+	 * @param game		- Reference to the associated gamespace
+	 * @returns bool	- ( true = Game is over ) ( false = Game is still running )
+	 */
+	inline bool check_game_over( memory& mem, Gamespace& game )
+	{
+		if ( !game._game_state._game_is_over.load() )
+			return false;
+		mem._kill.store( true );
+		if ( game._game_state._playerDead.load() )
+			mem._kill_code.store( PLAYER_LOSE_CODE );
+		else if ( game._game_state._allEnemiesDead.load() )
+			mem._kill_code.store( PLAYER_WIN_CODE );
+		return true;
+	}
+
+	/**
+	 * @struct TickPeriods
+	 * @brief The number of ticks between each periodic simulation task, converted from the configured durations.
+	 */
+	struct TickPeriods {
+		unsigned long long
+			_npc,	///< @brief Ticks between NPC cycles.
+			_regen;	///< @brief Ticks between passive regen cycles.
+
+		explicit TickPeriods( const GameRules& cfg ) : _npc( toTicks( __NPC_CLOCK ) ), _regen( toTicks( cfg._regen_timer ) ) {}
+
+		/**
+		 * due(unsigned long long, unsigned long long)
+		 * @brief Checks if a periodic task should run during a given tick. Tasks run on the last tick of each period, so nothing runs on the first tick of the game.
+		 * @param tick		- The current tick number.
+		 * @param period	- The number of ticks between each run.
+		 * @returns bool
+		 */
+		[[nodiscard]] static bool due( const unsigned long long tick, const unsigned long long period ) noexcept { return ( tick + 1ull ) % period == 0ull; }
+	};
+
+	/**
+	 * submit_tick(memory&, Gamespace&, TickPeriods&, JobSystem&, bool)
+	 * @brief Submits a single simulation tick to the job system as a graph of tasks: player input, then the NPC cycle (when due), level-ups, regen (when due), and finally finishTick(). \n
+	 * Each task depends on the one before it, so no task needs to lock the gamespace, while the NPC cycle spreads its own work across the pool.
+	 * @param mem		- Shared Memory
+	 * @param game		- Reference to the associated gamespace
+	 * @param periods	- Tick periods of the periodic tasks
+	 * @param jobs		- The job system to run tasks on
+	 * @param input		- When false, player input is not processed during this tick.
+	 * @returns JobSystem::Handle	- The last task of the tick.
+	 */
+	inline JobSystem::Handle submit_tick( memory& mem, Gamespace& game, const TickPeriods& periods, JobSystem& jobs, const bool input )
+	{
+		const auto tick{ game._game_state._tick.load() };
+		const auto player{ input ? jobs.submit( [&mem, &game] { task_player( mem, game ); } ) : nullptr };
+		const auto npc{ TickPeriods::due( tick, periods._npc ) ? jobs.submit( [&game] { game.actionAllNPC(); }, { player } ) : player };
+		const auto levels{ jobs.submit( [&game] { game.apply_level_ups(); }, { npc } ) };
+		const auto regen{ TickPeriods::due( tick, periods._regen ) ? jobs.submit( [&game] { game.apply_passive(); }, { levels } ) : levels };
+		return jobs.submit( [&game] { game.finishTick(); }, { regen } );
+	}
+
+	/**
+	 * display_loop(stop_token, memory&, FrameBuffer&)
+	 * @brief The main loop of the display thread. Draws the latest frame published by the simulation at most once per __FRAMETIME, and shows the pause screen while the game is paused. \n
+	 * Frames are read from the frame buffer's snapshots, so console output never blocks the simulation, and the simulation never blocks the display.
+	 * @param stop	- Stops the loop when requested.
 	 * @param mem	- Shared Memory
-	 * @param game	- Reference to the associated gamespace, passed with std::ref()
+	 * @param buffer	- The frame buffer to draw
 	 */
-	inline void thread_npc( std::mutex& mutx, memory& mem, Gamespace& game )
+	inline void display_loop( const std::stop_token& stop, memory& mem, FrameBuffer& buffer )
 	{
-		// loop until shared memory's kill flag is true
-		while ( !mem._kill.load() ) {
-			std::this_thread::sleep_for( __NPC_CLOCK );
-			if ( !mem._pause.load() ) {
-				std::scoped_lock<std::mutex> game_lock( mutx );	// lock the mutex
-				game.actionAllNPC();						// perform NPC actions
+		const auto frameLength{ std::chrono::duration_cast<CLK::duration>( __FRAMETIME ) };
+		for ( auto tNextFrame{ CLK::now() }; !stop.stop_requested() && !mem._kill.load(); ) {
+			if ( mem._pause.load() ) {
+				if ( !mem._pause_complete.load() ) {
+					// the pause flag is only read here, so an unpause can't be lost; the screen is cleared by the first frame drawn after it
+					buffer.deinitialize();
+					mem.show_pause_screen();
+					mem._pause_complete.store( true );
+				}
+			}
+			else {
+				mem._pause_complete.store( false );
+				try {
+					buffer.draw();
+				} catch ( std::exception& ) {}
 			}
-			else std::this_thread::sleep_for(1s);
+			const auto now{ CLK::now() };
+			tNextFrame += frameLength;
+			if ( tNextFrame < now ) // the display fell behind, don't try to catch up on frames
+				tNextFrame = now + frameLength;
+			std::this_thread::sleep_until( tNextFrame );
 		}
 	}
 
 	/**
-	 * game_thread_display(Gamespace&)
-	 * @brief Thread function that controls the display.
-	 * @param mutx	- Shared Mutex
+	 * run(memory&, Gamespace&, GameRules&, JobSystem&)
+	 * @brief Runs the game until the kill flag is set. \n
+	 * The simulation advances in fixed-length ticks: real time is added to an accumulator, and one tick is run for every __TICKTIME it contains, so the game runs at the same speed regardless of the framerate. \n
+	 * After a stall, missed ticks are run back-to-back to catch up without drifting, up to a limit of one second so that a long stall doesn't freeze the display. \n
+	 * After the ticks, a snapshot of the gamespace is published to the frame buffer, which is drawn by a separate display thread, see display_loop().
 	 * @param mem	- Shared Memory
-	 * @param game	- Reference to the associated gamespace, passed with std::ref()
+	 * @param game	- Reference to the associated gamespace
 	 * @param cfg	- Game Rules
+	 * @param jobs	- The job system to run tasks on
 	 */
-	inline void thread_display( std::mutex& mutx, memory& mem, Gamespace& game, GameRules& cfg )
+	inline void run( memory& mem, Gamespace& game, GameRules& cfg, JobSystem& jobs )
 	{
 		// create a frame buffer with the given gamespace ref
-		FrameBuffer gameBuffer( game, Coord( 1920 / 3, 1080 / 8 ) );
+		FrameBuffer gameBuffer( game, Coord( 1920 / 3, 1080 / 8 ), false, cfg._show_frame_stats );
+		game.attachJobs( &jobs );
+		const TickPeriods periods{ cfg };
+		const auto tickLength{ std::chrono::duration_cast<CLK::duration>( __TICKTIME ) };
+		const auto maxBacklog{ tickLength * __TICKRATE };
+		CLK::duration accumulator{ 0 };
+		gameBuffer.publish();
+		// the display thread is stopped & joined when this function returns, before the frame buffer is destroyed
+		std::jthread display( [&mem, &gameBuffer]( const std::stop_token& stop ) { display_loop( stop, mem, gameBuffer ); } );
 		// Loop until kill flag is true
-		for ( auto tLastRegenCycle{ CLK::now() }; !mem._kill.load(); ) {
-			if ( !mem._pause.load() ) {
-				mem._pause_complete.store( false );
+		for ( auto tPrevious{ CLK::now() }; !mem._kill.load(); ) {
+			if ( mem._pause.load() ) {
 				std::this_thread::sleep_for( __FRAMETIME );
-				std::scoped_lock<std::mutex> display_lock( mutx );
-				try {
-					gameBuffer.display();
-				} catch ( std::exception& ) {}
+				task_player( mem, game ); // check for the unpause key
+				tPrevious = CLK::now(); // time spent paused is not simulated
+				continue;
+			}
+			const auto now{ CLK::now() };
+			accumulator += now - tPrevious;
+			tPrevious = now;
+			if ( accumulator > maxBacklog )
+				accumulator = maxBacklog;
 
-				game.apply_level_ups();
-				if ( game._game_state._game_is_over.load() ) {
-					mem._kill.store( true );
-					if ( game._game_state._playerDead.load() )
-						mem._kill_code.store( PLAYER_LOSE_CODE );
-					else if ( game._game_state._allEnemiesDead.load() )
-						mem._kill_code.store( PLAYER_WIN_CODE );
+			auto ticked{ false };
+			for ( ; accumulator >= tickLength && !mem._kill.load(); accumulator -= tickLength ) {
+				jobs.wait( submit_tick( mem, game, periods, jobs, true ) );
+				ticked = true;
+				if ( check_game_over( mem, game ) )
 					break;
-				}
-				// ReSharper disable once CppRedundantElseKeywordInsideCompoundStatement
-				else if ( CLK::now() - tLastRegenCycle >= cfg._regen_timer ) {
-					game.apply_passive();
-					tLastRegenCycle = CLK::now();
-				}
 			}
-			else if ( !mem._pause_complete.load() ) {
-				gameBuffer.deinitialize();
-				mem.pause_game();
-				mem._pause_complete.store( true );
+			if ( mem._kill.load() )
+				break;
+			// the display only ever shows the latest state, so one snapshot is enough after catching up on several ticks
+			if ( ticked )
+				gameBuffer.publish();
+			// sleep until the next tick is due
+			std::this_thread::sleep_until( now + ( tickLength - accumulator ) );
+		}
+		game.attachJobs( nullptr );
+	}
+
+	/**
+	 * run_headless(memory&, Gamespace&, GameRules&, JobSystem&, unsigned long long)
+	 * @brief Runs the simulation as fast as possible, without a display or player input, until the game is over or a number of ticks have passed. \n
+	 * Because every task is expressed in ticks, the outcome is the same as running the same ticks in real time.
+	 * @param mem		- Shared Memory
+	 * @param game		- Reference to the associated gamespace
+	 * @param cfg		- Game Rules
+	 * @param jobs		- The job system to run tasks on
+	 * @param maxTicks	- The number of ticks to run, or 0 to run until the game is over.
+	 */
+	inline void run_headless( memory& mem, Gamespace& game, GameRules& cfg, JobSystem& jobs, const unsigned long long maxTicks )
+	{
+		game.attachJobs( &jobs );
+		const TickPeriods periods{ cfg };
+		while ( !mem._kill.load() ) {
+			if ( maxTicks > 0ull && game._game_state._tick.load() >= maxTicks ) {
+				mem._kill_code.store( PLAYER_QUIT_CODE );
+				mem._kill.store( true );
+				break;
 			}
-			else
-				std::this_thread::sleep_for( __FRAMETIME );
+			jobs.wait( submit_tick( mem, game, periods, jobs, false ) );
+			if ( check_game_over( mem, game ) )
+				break;
 		}
+		game.attachJobs( nullptr );
 	}
-}
+}
\ No newline at end of file
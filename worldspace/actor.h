@@ -6,6 +6,7 @@
  */
 #pragma once
 #include <algorithm>
+#include <cstdint>
 #include <file.h>
 #include <sstream>
 #include <strconv.hpp>
@@ -14,9 +15,11 @@
 #include <sysapi.h>
 #include <utility>
 #include <vector>
-#include <xRand.h>
 #include "controls.h"
 #include "Coord.h"
+#include "lod.h"
+#include "pathfinder.h"
+#include "rng.h"
 
 // Universal attributes and templates
 #pragma region ACTOR_ATTRIBUTES
@@ -33,6 +36,34 @@ enum class FACTION {
 	NONE = 3,	// actors cannot be members of this faction, but it can be used to create passive NPCs
 };
 
+/**
+ * @brief Bitmask of factions, where each faction is represented by the bit at the index of its enum value.
+ */
+using FactionMask = unsigned;
+/**
+ * factionBit(FACTION)
+ * @brief Returns the bit that represents a given faction in a FactionMask.
+ * @param faction		- Target faction
+ * @returns FactionMask
+ */
+constexpr FactionMask factionBit(const FACTION faction) { return 1u << static_cast<unsigned>(faction); }
+constexpr FactionMask FACTION_MASK_ALL{ factionBit(FACTION::PLAYER) | factionBit(FACTION::ENEMY) | factionBit(FACTION::NEUTRAL) | factionBit(FACTION::NONE) };
+constexpr FactionMask FACTION_MASK_MEMBERS{ FACTION_MASK_ALL & ~factionBit(FACTION::NONE) }; ///< @brief Every faction that actors can be members of.
+
+/**
+ * factionMask(vector<FACTION>&)
+ * @brief Converts a list of factions to a FactionMask.
+ * @param factions		- Any number of factions
+ * @returns FactionMask
+ */
+inline FactionMask factionMask(const std::vector<FACTION>& factions)
+{
+	FactionMask mask{ 0u };
+	for ( const auto& it : factions )
+		mask |= factionBit(it);
+	return mask;
+}
+
 /**
  * strToFactions(string&)
  * @brief Converts a string to a vector of factions.
@@ -102,11 +133,14 @@ public:
 	[[nodiscard]] int getMaxHealth() const	{ return _MAX_HEALTH; }
 	[[nodiscard]] int getMaxStamina() const { return _MAX_STAMINA; }
 	[[nodiscard]] int getMaxDamage() const	{ return _MAX_DAMAGE; }
+	[[nodiscard]] int getBaseHealth() const	{ return _BASE_HEALTH; }
+	[[nodiscard]] int getBaseStamina() const { return _BASE_STAMINA; }
+	[[nodiscard]] int getBaseDamage() const	{ return _BASE_DAMAGE; }
 };
 
 /**
  * @struct ActorStats
- * @brief Contains all actor universal statistics, and is the base of ActorBase.
+ * @brief Contains all actor universal statistics. ActorTemplate uses this to initialize the components of new actors.
  */
 struct ActorStats : ActorMaxStats {
 private:
@@ -335,40 +369,257 @@ struct ActorTemplate {
 };
 
 #pragma endregion  ACTOR_ATTRIBUTES
+// Dense storage of actor components
+#pragma region ACTOR_STORE
+struct ActorBase;
+using EntityId = std::uint32_t; ///< @brief Index of an actor's components in an ActorStore.
+constexpr EntityId NULL_ENTITY{ 0xFFFFFFFFu }; ///< @brief Entity id of an empty handle.
+
+/**
+ * @struct ActorHandle
+ * @brief Stable reference to an actor, made of its entity id & the generation of that id when the handle was taken. \n
+ * Each time an id is released its generation is incremented, so a handle to a removed actor never resolves, even after its id is reused. \n
+ * Unlike a pointer, a handle stays valid when the actor object is moved to a different address.
+ */
+struct ActorHandle final {
+	EntityId _id{ NULL_ENTITY };		///< @brief The actor's entity id.
+	std::uint32_t _generation{ 0u };	///< @brief The generation of the id when this handle was taken.
+
+	/**
+	 * empty()
+	 * @brief Checks if this handle was never set, or was cleared.
+	 * @returns bool
+	 */
+	[[nodiscard]] bool empty() const noexcept { return _id == NULL_ENTITY; }
+	[[nodiscard]] bool operator==(const ActorHandle&) const noexcept = default;
+};
+
+/**
+ * @struct ActorStore
+ * @brief Stores the frequently used data of every actor in dense arrays indexed by entity id, one array per component. \n
+ * Passes that only touch one or two components, like regeneration or rendering, loop over the arrays directly instead of going through each actor. \n
+ * Actor objects only keep their entity id & the data that is rarely used, such as their name. \n
+ * This is also a slot map of the actor objects: the store tracks the current address of the actor using each id, so an ActorHandle can be resolved to it in constant time.
+ */
+struct ActorStore final {
+	std::vector<Coord> _pos;				///< @brief Current position.
+	std::vector<FACTION> _faction;			///< @brief Faction.
+	std::vector<FactionMask> _hostile;		///< @brief Factions the actor is hostile to.
+	std::vector<int> _level;				///< @brief Current level.
+	std::vector<int> _health;				///< @brief Current health.
+	std::vector<int> _stamina;				///< @brief Current stamina.
+	std::vector<int> _max_health;			///< @brief Maximum health.
+	std::vector<int> _max_stamina;			///< @brief Maximum stamina.
+	std::vector<int> _max_damage;			///< @brief Maximum damage.
+	std::vector<int> _vis;					///< @brief Sight range in tiles.
+	std::vector<int> _kills;				///< @brief Kill count / experience.
+	std::vector<int> _aggro;				///< @brief Current aggression, this is always 0 for the player.
+	std::vector<ActorHandle> _target;		///< @brief Current target, this is always empty for the player.
+	std::vector<char> _char;				///< @brief Display character.
+	std::vector<unsigned short> _color;		///< @brief Display color.
+	std::vector<unsigned char> _dead;		///< @brief Set when the actor died.
+	std::vector<unsigned char> _used;		///< @brief Set while the id belongs to an actor, released ids are skipped by passes over the arrays.
+	std::vector<unsigned char> _stimulus;	///< @brief Set when something changed within the actor's sight since it last looked for targets.
+	std::vector<std::uint32_t> _generation;	///< @brief Incremented each time the id is released, handles taken before that no longer resolve.
+	std::vector<ActorBase*> _owner;			///< @brief The actor object currently using the id. Actors update this themselves when they are moved.
+	std::vector<EntityId> _free;			///< @brief Released ids that can be given to new actors.
+	std::vector<EntityId> _kills_changed;	///< @brief Ids whose kill count changed since the last level-up pass, may contain duplicates.
+
+	/**
+	 * size()
+	 * @brief Returns the length of the component arrays, including released ids.
+	 * @returns size_t
+	 */
+	[[nodiscard]] size_t size() const noexcept { return _used.size(); }
+
+	/**
+	 * create(FACTION, Coord&, char, unsigned short, FactionMask, ActorStats&)
+	 * @brief Creates the components of a new actor, reusing a released id if there is one.
+	 * @param faction	- The actor's faction.
+	 * @param pos		- The actor's position.
+	 * @param ch		- The actor's display character.
+	 * @param color		- The actor's display color.
+	 * @param hostile	- The factions the actor is hostile to.
+	 * @param stats		- The actor's starting stats.
+	 * @returns EntityId
+	 */
+	EntityId create(const FACTION faction, const Coord& pos, const char ch, const unsigned short color, const FactionMask hostile, const ActorStats& stats)
+	{
+		EntityId id;
+		if ( !_free.empty() ) {
+			id = _free.back();
+			_free.pop_back();
+		}
+		else {
+			id = static_cast<EntityId>(_used.size());
+			for ( auto* it : { &_level, &_health, &_stamina, &_max_health, &_max_stamina, &_max_damage, &_vis, &_kills, &_aggro } )
+				it->emplace_back(0);
+			_pos.emplace_back();
+			_faction.emplace_back(FACTION::NONE);
+			_hostile.emplace_back(0u);
+			_target.emplace_back();
+			_char.emplace_back(' ');
+			_color.emplace_back(static_cast<unsigned short>(0u));
+			_dead.emplace_back(static_cast<unsigned char>(0u));
+			_used.emplace_back(static_cast<unsigned char>(0u));
+			_stimulus.emplace_back(static_cast<unsigned char>(0u));
+			_generation.emplace_back(0u);
+			_owner.emplace_back(nullptr);
+		}
+		_pos[id] = pos;
+		_faction[id] = faction;
+		_hostile[id] = hostile;
+		_level[id] = stats.getLevel();
+		_health[id] = stats.getHealth();
+		_stamina[id] = stats.getStamina();
+		_max_health[id] = stats.getMaxHealth();
+		_max_stamina[id] = stats.getMaxStamina();
+		_max_damage[id] = stats.getMaxDamage();
+		_vis[id] = stats.getVis();
+		_kills[id] = 0;
+		_aggro[id] = 0;
+		_target[id] = {};
+		_char[id] = ch;
+		_color[id] = color;
+		_dead[id] = static_cast<unsigned char>(_health[id] == 0);
+		_used[id] = static_cast<unsigned char>(1u);
+		_stimulus[id] = static_cast<unsigned char>(1u); // new actors look around on their first turn
+		return id;
+	}
+
+	/**
+	 * release(EntityId)
+	 * @brief Marks an id as unused, so it can be given to the next actor that is created. \n
+	 * This invalidates every handle to the id. The actor that owned it must not be used afterwards.
+	 * @param id	- The id of a removed actor.
+	 */
+	void release(const EntityId id)
+	{
+		if ( id >= _used.size() || _used[id] == 0u )
+			return;
+		_used[id] = static_cast<unsigned char>(0u);
+		++_generation[id];
+		_stimulus[id] = static_cast<unsigned char>(0u);
+		_target[id] = {};
+		_owner[id] = nullptr;
+		_free.emplace_back(id);
+	}
+
+private:
+	/**
+	 * regenerate_stat(size_t, int, int, FACTION*, unsigned char*, unsigned char*, int*, int*)
+	 * @brief Adds an amount to one stat of every living actor, clamping the results to [0, max]. \n
+	 * The loop is branch-free, and every array is passed as a restrict pointer so the compiler knows they don't overlap & can vectorize it.
+	 * @tparam Lethal	- When true, actors whose stat drops to 0 are marked as dead.
+	 * @param count		- The length of the arrays.
+	 * @param amount	- The amount to add to the player, negative values remove.
+	 * @param npcMult	- Multiplier applied to the amount for actors that aren't the player.
+	 * @param faction	- The faction array.
+	 * @param used		- The used array.
+	 * @param dead		- The dead array.
+	 * @param value		- The array of the stat to modify.
+	 * @param max		- The array of the stat's maximum values.
+	 */
+	template<bool Lethal>
+	static void regenerate_stat(const size_t count, const int amount, const int npcMult, const FACTION* __restrict faction, const unsigned char* __restrict used, unsigned char* __restrict dead, int* __restrict value, const int* __restrict max) noexcept
+	{
+		for ( size_t i{ 0u }; i < count; ++i ) {
+			// 1 for living actors, 0 for dead actors & released ids, which are left unchanged
+			const auto alive{ static_cast<int>(used[i] & ( dead[i] ^ 1u )) };
+			auto v{ value[i] + amount * ( faction[i] == FACTION::PLAYER ? 1 : npcMult ) * alive };
+			v = v > max[i] ? max[i] : v;
+			if constexpr ( Lethal )
+				dead[i] = static_cast<unsigned char>(dead[i] | static_cast<unsigned char>(alive & ( v <= 0 )));
+			value[i] = v < 0 ? 0 : v;
+		}
+	}
+
+public:
+	/**
+	 * regenerate(int, int, int)
+	 * @brief Adds health & stamina to every living actor in one pass per stat, clamping the results to [0, max]. Actors whose health drops to 0 are marked as dead.
+	 * @param health	- The amount of health to add to the player, negative values remove health.
+	 * @param stamina	- The amount of stamina to add to the player, negative values remove stamina.
+	 * @param npcMult	- Multiplier applied to both amounts for actors that aren't the player.
+	 */
+	void regenerate(const int health, const int stamina, const int npcMult) noexcept
+	{
+		// stamina first, an actor killed by the health pass still had its stamina modified
+		regenerate_stat<false>(size(), stamina, npcMult, _faction.data(), _used.data(), _dead.data(), _stamina.data(), _max_stamina.data());
+		regenerate_stat<true>(size(), health, npcMult, _faction.data(), _used.data(), _dead.data(), _health.data(), _max_health.data());
+	}
+
+	/**
+	 * handle(EntityId)
+	 * @brief Returns a handle to the actor currently using a given id.
+	 * @param id	- Target entity id.
+	 * @returns ActorHandle
+	 */
+	[[nodiscard]] ActorHandle handle(const EntityId id) const noexcept { return { id, _generation[id] }; }
+
+	/**
+	 * resolve(ActorHandle&)
+	 * @brief Returns the actor that a handle refers to.
+	 * @param h				- Target handle.
+	 * @returns ActorBase*	- The actor's current address, or nullptr if the handle is empty, or the actor was removed.
+	 */
+	[[nodiscard]] ActorBase* resolve(const ActorHandle& h) const noexcept { return h._id < _generation.size() && _generation[h._id] == h._generation ? _owner[h._id] : nullptr; }
+};
+#pragma endregion	  ACTOR_STORE
 // Base class of all actors
 #pragma region ACTOR_BASE
 /**
  * @struct ActorBase
- * @brief This is the base virtual object of every actor in the game. An ActorBase* parameter in a function means any actor can be operated on by the function.
+ * @brief This is the base virtual object of every actor in the game. An ActorBase* parameter in a function means any actor can be operated on by the function. \n
+ * The position, stats, faction, aggression & target of an actor are kept in an ActorStore, this object is a view of them through its entity id.
  */
-struct ActorBase : ActorStats {
+struct ActorBase {
 protected:
+	ActorStore* _store;					///< The store that contains this actor's components.
+	EntityId _id;						///< This actor's index in the store.
 	std::string _name;					///< This actor's name.
-	FACTION _faction;					///< This actor's Faction.
-	Coord _pos;							///< This actor's current position.
-	char _char;							///< This actor's display character.
-	unsigned short _color;				///< The color of this actor's display character.
-	std::vector<FACTION> _hostileTo;	///< Factions this actor is hostile to.
-	int _kill_count;					///< This actor's kill count / experience.
+	int _BASE_HEALTH, _BASE_STAMINA, _BASE_DAMAGE; ///< This actor's starting stats, used to calculate max stats when leveling up.
+	std::string _killedBy{};			///< Name of the actor who killed me.
 
-private:
 	/**
-	 * initHostilities()
-	 * @brief Initializes this actor's hostile faction list with all factions marked as hostile.
+	 * update_stats(int)
+	 * @brief Sets this actor's level to a new value, and updates their stats accordingly. This function is called by addLevel()
+	 * @param newLevel		- The new level to set
 	 */
-	void initHostilities()
+	void update_stats(const int newLevel)
 	{
-		for ( auto i = static_cast<int>(FACTION::PLAYER); i < static_cast<int>(FACTION::NONE); i++ ) {
-			auto thisFaction{ static_cast<FACTION>(i) };
-			if ( thisFaction != _faction )
-				_hostileTo.push_back(thisFaction);
+		_store->_level[_id] = newLevel;
+		if ( newLevel % 3 == 0 ) {
+			_store->_max_health[_id] = static_cast<int>(static_cast<float>(_BASE_HEALTH) * (static_cast<float>(newLevel) / 1.5f));
+			_store->_max_stamina[_id] = static_cast<int>(static_cast<float>(_BASE_STAMINA) * (static_cast<float>(newLevel) / 1.3f));
+			_store->_max_damage[_id] = static_cast<int>(static_cast<float>(_BASE_DAMAGE) * (static_cast<float>(newLevel) / 1.9f));
 		}
 	}
 
+	/**
+	 * restore_all_stats()
+	 * @brief Restores all stats to their max values.
+	 */
+	void restore_all_stats()
+	{
+		_store->_health[_id] = _store->_max_health[_id];
+		_store->_stamina[_id] = _store->_max_stamina[_id];
+	}
+
+private:
+	/**
+	 * defaultHostilities(FACTION)
+	 * @brief Returns a mask with all factions except the given one marked as hostile.
+	 * @param faction	- This actor's faction.
+	 * @returns FactionMask
+	 */
+	[[nodiscard]] static FactionMask defaultHostilities(const FACTION faction) { return FACTION_MASK_MEMBERS & ~factionBit(faction); }
+
 public:
 	/** CONSTRUCTOR **
-	 * ActorBase(FACTION, string, Coord&, char, unsigned short, ActorStats&)
+	 * ActorBase(ActorStore&, FACTION, string, Coord&, char, unsigned short, ActorStats&)
 	 * @brief Construct an actor from an ActorStats instance.
+	 * @param store		 - The store to create my components in.
 	 * @param myFaction	 - My faction / group of actors.
 	 * @param myName	 - My reporting name.
 	 * @param myPos		 - My current position as a matrix coordinate
@@ -376,43 +627,184 @@ public:
 	 * @param myColor	 - My character's color when inserted into a stream
 	 * @param myStats	 - My base statistics
 	 */
-	ActorBase(const FACTION myFaction, std::string myName, const Coord& myPos, const char myChar, const unsigned short myColor, const ActorStats& myStats) : ActorStats(myStats), _name(std::move(myName)), _faction(myFaction), _pos(myPos), _char(myChar), _color(myColor), _kill_count(0) { initHostilities(); }
+	ActorBase(ActorStore& store, const FACTION myFaction, std::string myName, const Coord& myPos, const char myChar, const unsigned short myColor, const ActorStats& myStats) : _store(&store), _id(store.create(myFaction, myPos, myChar, myColor, defaultHostilities(myFaction), myStats)), _name(std::move(myName)), _BASE_HEALTH(myStats.getBaseHealth()), _BASE_STAMINA(myStats.getBaseStamina()), _BASE_DAMAGE(myStats.getBaseDamage()) { _store->_owner[_id] = this; }
 	/** CONSTRUCTOR **
-	 * ActorBase(FACTION, Coord&, ActorTemplate&)
+	 * ActorBase(ActorStore&, FACTION, Coord&, ActorTemplate&)
 	 * @brief Construct an actor from a template.
+	 * @param store		 - The store to create my components in.
 	 * @param myFaction	 - My faction / group of actors.
 	 * @param myPos		 - My current position as a matrix coordinate
 	 * @param myTemplate - My templated stats
 	 */
-	ActorBase(const FACTION myFaction, const Coord& myPos, ActorTemplate& myTemplate) : ActorStats(myTemplate._stats), _name(myTemplate._name), _faction(myFaction), _pos(myPos), _char(myTemplate._char), _color(myTemplate._color), _hostileTo(myTemplate._hostile_to), _kill_count(0) { if ( myTemplate._hostile_to.empty() && _hostileTo.empty() ) initHostilities(); }
+	ActorBase(ActorStore& store, const FACTION myFaction, const Coord& myPos, ActorTemplate& myTemplate) : _store(&store), _id(store.create(myFaction, myPos, myTemplate._char, myTemplate._color, myTemplate._hostile_to.empty() ? defaultHostilities(myFaction) : factionMask(myTemplate._hostile_to), myTemplate._stats)), _name(myTemplate._name), _BASE_HEALTH(myTemplate._stats.getBaseHealth()), _BASE_STAMINA(myTemplate._stats.getBaseStamina()), _BASE_DAMAGE(myTemplate._stats.getBaseDamage()) { _store->_owner[_id] = this; }
 #pragma region DEF
-	ActorBase(const ActorBase&) = default;
-	ActorBase(ActorBase&&) = default;
+	ActorBase(const ActorBase&) = delete;	///< @brief Deleted, a copy would share the same components.
+	/**
+	 * ActorBase(ActorBase&&)
+	 * @brief Move constructor, registers the new address with the store so that handles to this actor resolve to it.
+	 */
+	ActorBase(ActorBase&& o) noexcept : _store(o._store), _id(o._id), _name(std::move(o._name)), _BASE_HEALTH(o._BASE_HEALTH), _BASE_STAMINA(o._BASE_STAMINA), _BASE_DAMAGE(o._BASE_DAMAGE), _killedBy(std::move(o._killedBy)) { _store->_owner[_id] = this; }
 	virtual ~ActorBase() = default;
-	ActorBase& operator=(const ActorBase&) = default;
-	ActorBase& operator=(ActorBase&&) = default;
+	ActorBase& operator=(const ActorBase&) = delete;
+	/**
+	 * operator=(ActorBase&&)
+	 * @brief Move operator, registers the new address with the store so that handles to this actor resolve to it. The id of the overwritten actor must have been released.
+	 */
+	ActorBase& operator=(ActorBase&& o) noexcept
+	{
+		_store = o._store;
+		_id = o._id;
+		_name = std::move(o._name);
+		_BASE_HEALTH = o._BASE_HEALTH;
+		_BASE_STAMINA = o._BASE_STAMINA;
+		_BASE_DAMAGE = o._BASE_DAMAGE;
+		_killedBy = std::move(o._killedBy);
+		_store->_owner[_id] = this;
+		return *this;
+	}
 #pragma endregion DEF
 
+	/**
+	 * handle()
+	 * @brief Returns a stable handle to this actor, which stays valid when it is moved & expires when it is removed.
+	 * @returns ActorHandle
+	 */
+	[[nodiscard]] ActorHandle handle() const { return _store->handle(_id); }
+
+	/**
+	 * id()
+	 * @brief Returns this actor's entity id, which is its index in the store.
+	 * @returns EntityId
+	 */
+	[[nodiscard]] EntityId id() const { return _id; }
+
+	/**
+	 * setMaxHealth(unsigned int)
+	 * @brief Set the max/base health values of an actor. This will also restore all stats to max.
+	 * @param newValue	- The new max/base health value
+	 */
+	void setMaxHealth(const unsigned int newValue)
+	{
+		_store->_max_health[_id] = static_cast<signed>(newValue);
+		_BASE_HEALTH = _store->_max_health[_id];
+		restore_all_stats();
+	}
+	/**
+	 * setMaxStamina(unsigned int)
+	 * @brief Sets the maximum & base stamina of an actor. This will also restore all stats to max.
+	 * @param newValue	- The new max/base stamina value
+	 */
+	void setMaxStamina(const unsigned int newValue)
+	{
+		_store->_max_stamina[_id] = static_cast<signed>(newValue);
+		_BASE_STAMINA = _store->_max_stamina[_id];
+		restore_all_stats();
+	}
+	/**
+	 * setMaxDamage(unsigned int)
+	 * @brief Set the maximum damage value of an actor. This will also restore all stats to max.
+	 * @param newValue	- The new max damage value.
+	 */
+	void setMaxDamage(const unsigned int newValue)
+	{
+		_store->_max_damage[_id] = static_cast<signed>(newValue);
+		_BASE_DAMAGE = _store->_max_damage[_id];
+		restore_all_stats();
+	}
+	/**
+	 * killedBy(string&)
+	 * @brief Optionally sets, and returns the name of this actor's killer.
+	 * @param killer	- (Default: {}}) When not empty, sets the name of this actor's killer to the given string.
+	 * @returns string
+	 */
+	std::string killedBy(const std::string& killer = {})
+	{
+		if ( !killer.empty() )
+			_killedBy = killer;
+		return _killedBy;
+	}
+	[[nodiscard]] int getMaxHealth() const { return _store->_max_health[_id]; } ///< @brief Returns the maximum health of this instance. @returns int
+	[[nodiscard]] int getMaxStamina() const { return _store->_max_stamina[_id]; } ///< @brief Returns the maximum stamina of this instance. @returns int
+	[[nodiscard]] int getMaxDamage() const { return _store->_max_damage[_id]; } ///< @brief Returns the maximum damage of this instance. @returns int
+	[[nodiscard]] int getLevel() const { return _store->_level[_id]; } ///< @brief Returns the current level of this instance. @returns int
+	[[nodiscard]] auto getVis() const -> int { return _store->_vis[_id]; } ///< @brief Returns the current visibility range of this instance. @returns int
+	void addLevel() { update_stats(_store->_level[_id] + 1); } ///< @brief Increase the current level of this instance by one.
+	void subLevel() { update_stats(_store->_level[_id] > 1 ? _store->_level[_id] - 1 : 1); } ///< @brief Decrease the current level of this instance by one.
+	[[nodiscard]] int getHealth() const { return _store->_health[_id]; } ///< @brief Returns the current health of this instance. @returns int
+	[[nodiscard]] int getStamina() const { return _store->_stamina[_id]; } ///< @brief Returns the current stamina value of this instance. @returns int
+	/**
+	 * setHealth(int)
+	 * @brief Sets the actor's health to a new value, and automatically sets the dead flag if it is below 0.
+	 * @param newValue	- The new health value
+	 * @returns int		- The new health value
+	 */
+	int setHealth(int newValue)
+	{
+		// check if the new value is above the max
+		if ( newValue > _store->_max_health[_id] )
+			newValue = _store->_max_health[_id];
+		// check if the new value is below or equal to 0
+		else if ( newValue <= 0 ) {
+			newValue = 0;
+			_store->_dead[_id] = static_cast<unsigned char>(1u);
+		}
+		// set the new value
+		_store->_health[_id] = newValue;
+		return newValue;
+	}
+	/**
+	 * modHealth(int)
+	 * @brief Modifies the actor's health value, and automatically sets the dead flag if it drops below 0.
+	 * @param modValue	- The amount to modify health by, negative removes, positive adds.
+	 * @returns int		- The new health value
+	 */
+	int modHealth(const int modValue) { return setHealth(_store->_health[_id] + modValue); }
+	/**
+	 * setStamina(int)
+	 * @brief Sets the actor's stamina to a new value.
+	 * @param newValue	- The new stamina value
+	 * @returns int		- The new stamina value
+	 */
+	int setStamina(int newValue)
+	{
+		// check if the new value is above the max
+		if ( newValue > _store->_max_stamina[_id] )
+			newValue = _store->_max_stamina[_id];
+		// check if the new value is below or equal to 0
+		else if ( newValue <= 0 )
+			newValue = 0;
+		// set the new value
+		_store->_stamina[_id] = newValue;
+		return newValue;
+	}
+	/**
+	 * modStamina(int)
+	 * @brief Modifies the actor's stamina value.
+	 * @param modValue	- The amount to modify stamina by, negative removes, positive adds.
+	 * @returns int		- The new stamina value
+	 */
+	int modStamina(const int modValue) { return setStamina(_store->_stamina[_id] + modValue); }
+
 	/**
 	 * moveU()
 	 * @brief Set this actor's position to the tile above.
 	 */
-	void moveU() { _pos._y--; }
+	void moveU() { _store->_pos[_id]._y--; }
 	/**
 	 * moveD()
 	 * @brief Set this actor's position to the tile below.
 	 */
-	void moveD() { _pos._y++; }
+	void moveD() { _store->_pos[_id]._y++; }
 	/**
 	 * moveL()
 	 * @brief Set this actor's position to the tile to the left.
 	 */
-	void moveL() { _pos._x--; }
+	void moveL() { _store->_pos[_id]._x--; }
 	/**
 	 * moveR()
 	 * @brief Set this actor's position to the tile to the right.
 	 */
-	void moveR() { _pos._x++; }
+	void moveR() { _store->_pos[_id]._x++; }
 	/**
 	 * moveDir()
 	 * @brief Set this actor's position to the tile in a given direction.
@@ -434,25 +826,25 @@ public:
 	 * @brief Returns the coordinate of the tile above this actor.
 	 * @returns Coord
 	 */
-	[[nodiscard]] Coord getPosU() const { return { _pos._x, _pos._y - 1 }; }
+	[[nodiscard]] Coord getPosU() const { return { pos()._x, pos()._y - 1 }; }
 	/**
 	 * getPosD()
 	 * @brief Returns the coordinate of the tile below this actor.
 	 * @returns Coord
 	 */
-	[[nodiscard]] Coord getPosD() const { return { _pos._x, _pos._y + 1 }; }
+	[[nodiscard]] Coord getPosD() const { return { pos()._x, pos()._y + 1 }; }
 	/**
 	 * getPosL()
 	 * @brief Returns the coordinate of the tile to the left of this actor.
 	 * @returns Coord
 	 */
-	[[nodiscard]] Coord getPosL() const { return { _pos._x - 1, _pos._y }; }
+	[[nodiscard]] Coord getPosL() const { return { pos()._x - 1, pos()._y }; }
 	/**
 	 * getPosR()
 	 * @brief Returns the coordinate of the tile to the right of this actor.
 	 * @returns Coord
 	 */
-	[[nodiscard]] Coord getPosR() const { return { _pos._x + 1, _pos._y }; }
+	[[nodiscard]] Coord getPosR() const { return { pos()._x + 1, pos()._y }; }
 	/**
 	 * getPosDir()
 	 * @brief Returns the coordinate of the tile in the given direction, in relation to the position of this actor.
@@ -479,15 +871,10 @@ public:
 	 */
 	void setRelationship(const FACTION faction, const bool hostile)
 	{
-		for ( size_t it{ 0 }; it < _hostileTo.size(); it++ ) {
-			if ( _hostileTo.at(it) == faction ) {
-				if ( !hostile ) // remove faction hostility
-					_hostileTo.erase(_hostileTo.begin() + it);
-				else return; // faction is already hostile
-			}
-		}
-		// Add this faction as hostile
-		_hostileTo.push_back(faction);
+		if ( hostile )
+			_store->_hostile[_id] |= factionBit(faction);
+		else
+			_store->_hostile[_id] &= ~factionBit(faction);
 	}
 	
 	/**
@@ -496,7 +883,7 @@ public:
 	 * @param target	- A faction
 	 * @returns bool	- ( true = this actor is hostile to target ) ( false = this actor is not hostile to target )
 	 */
-	bool isHostileTo(const FACTION target) { return std::ranges::any_of(_hostileTo.begin(), _hostileTo.end(), [&target](FACTION& it) -> bool { return it == target; }); }
+	[[nodiscard]] bool isHostileTo(const FACTION target) const { return ( _store->_hostile[_id] & factionBit(target) ) != 0u; }
 
 	/**
 	 * isHostileTo(ActorBase*)
@@ -504,20 +891,27 @@ public:
 	 * @param target	- Ptr to an actor
 	 * @returns bool	- ( true = this actor is hostile to target ) ( false = this actor is not hostile to target )
 	 */
-	bool isHostileTo(ActorBase* target) { return std::ranges::any_of(_hostileTo.begin(), _hostileTo.end(), [&target](FACTION& it) -> bool { return it == target->faction(); }); }
+	[[nodiscard]] bool isHostileTo(const ActorBase* target) const { return ( _store->_hostile[_id] & factionBit(target->faction()) ) != 0u; }
+
+	/**
+	 * hostileMask()
+	 * @brief Returns the mask of factions that this actor is hostile to.
+	 * @returns FactionMask
+	 */
+	[[nodiscard]] FactionMask hostileMask() const { return _store->_hostile[_id]; }
 
 	/**
 	 * setColor(unsigned short)
 	 * @brief Set this actor's color.
 	 * @param newColor	- New color
 	 */
-	void setColor(const unsigned short newColor) { _color = newColor; }
+	void setColor(const unsigned short newColor) { _store->_color[_id] = newColor; }
 	/**
 	 * getColor()
 	 * @brief Returns this actor's current display color.
 	 * @returns unsigned short
 	 */
-	[[nodiscard]] unsigned short getColor() const { return _color; }
+	[[nodiscard]] unsigned short getColor() const { return _store->_color[_id]; }
 	/**
 	 * name()
 	 * @brief Returns this actor's name.
@@ -529,44 +923,44 @@ public:
 	 * @brief Returns this actor's faction.
 	 * @returns FACTION
 	 */
-	[[nodiscard]] auto faction() const -> FACTION { return _faction; }
+	[[nodiscard]] auto faction() const -> FACTION { return _store->_faction[_id]; }
 	/**
 	 * pos()
 	 * @brief Returns this actor's current position.
 	 * @returns Coord
 	 */
-	[[nodiscard]] Coord pos() const { return _pos; }
-	/**
-	 * getPosPtr()
-	 * @brief Returns a pointer to this actor position value.
-	 * @returns Coord*
-	 */
-	[[nodiscard]] Coord* getPosPtr() { return &_pos; }
+	[[nodiscard]] Coord pos() const { return _store->_pos[_id]; }
 	/**
 	 * isDead()
 	 * @brief Checks if this actor is dead.
 	 * @returns bool	- ( true = This actor is dead ) ( false = This actor is alive )
 	 */
-	[[nodiscard]] bool isDead() const { return _dead; }
+	[[nodiscard]] bool isDead() const { return _store->_dead[_id] != 0u; }
 	/**
 	 * getChar()
 	 * @brief Returns this actor's display character.
 	 * @returns char
 	 */
-	[[nodiscard]] char getChar() const { return _char; }
+	[[nodiscard]] char getChar() const { return _store->_char[_id]; }
 	/**
 	 * getKills()
 	 * @brief Returns this actor's kill count.
 	 * @returns int
 	 */
-	[[nodiscard]] int getKills() const { return _kill_count; }
+	[[nodiscard]] int getKills() const { return _store->_kills[_id]; }
 	/**
 	 * addKill()
 	 * @brief Adds to this actor's kill count.
 	 * @param count	- (Default: 1) The number of kills to add.
 	 * @returns int	- This actor's new kill count.
 	 */
-	int addKill(const int count = 1) { return count > 0 ? _kill_count += count : _kill_count; }
+	int addKill(const int count = 1)
+	{
+		if ( count <= 0 )
+			return _store->_kills[_id];
+		_store->_kills_changed.emplace_back(_id);
+		return _store->_kills[_id] += count;
+	}
 
 	/**
 	 * print()
@@ -574,8 +968,8 @@ public:
 	 */
 	void print() const
 	{
-		sys::colorSet(_color);
-		printf("%c", _char);
+		sys::colorSet(getColor());
+		printf("%c", getChar());
 		sys::colorReset();
 	}
 };
@@ -587,41 +981,33 @@ public:
  * @brief This is a player actor, which (should be) controlled by a human.
  */
 struct Player final : ActorBase {
-	// ReSharper disable once CppInconsistentNaming
-	checkDistanceFrom getDist;		///< @brief Functor that gets the distance from the player's current position to a given Coord point.
-	
 	/**
 	 * resurrect()
 	 * @brief Revives the player to max health, and removes the dead flag.
 	 */
-	void resurrect() { _dead = false; _health = _MAX_HEALTH; }
-
-	int* ptrLevel() { return &_level; }				///< @brief Return a pointer to the level value. @returns int*
-	int* ptrHealth() { return &_health; }			///< @brief Return a pointer to the health value. @returns int*
-	int* ptrMaxHealth() { return &_MAX_HEALTH; }	///< @brief Return a pointer to the max health value. @returns int*
-	int* ptrStamina() { return &_stamina; }			///< @brief Return a pointer to the stamina value. @returns int*
-	int* ptrMaxStamina() { return &_MAX_STAMINA; }	///< @brief Return a pointer to the max stamina value. @returns int*
-	int* ptrKills() { return &_kill_count; }		///< @brief Return a pointer to the kill count value. @returns int*
+	void resurrect() { _store->_dead[_id] = static_cast<unsigned char>(0u); _store->_health[_id] = _store->_max_health[_id]; }
 	
 	/** CONSTRUCTOR **
-	 * Player(FACTION, string, Coord, char, unsigned short, int)
+	 * Player(ActorStore&, string, Coord, char, unsigned short, int)
 	 * @brief This is the base constructor for actor types.
+	 * @param store		- The store to create my components in.
 	 * @param myName	- My reporting name.
 	 * @param myPos		- My current position as a matrix coordinate
 	 * @param myChar	- My display character when inserted into a stream
 	 * @param myColor	- My character's color when inserted into a stream
 	 * @param myStats	- My statistics
 	 */
-	Player(const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const ActorStats
-		& myStats) : ActorBase(FACTION::PLAYER, myName, myPos, myChar, myColor, myStats), getDist(_pos) {}
+	Player(ActorStore& store, const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const ActorStats
+		& myStats) : ActorBase(store, FACTION::PLAYER, myName, myPos, myChar, myColor, myStats) {}
 
 	/**
-	 * Player(Coord&, ActorTemplate&)
+	 * Player(ActorStore&, Coord&, ActorTemplate&)
 	 * @brief Construct a player from template
+	 * @param store		 - The store to create my components in.
 	 * @param myPos		 - My current position as a matrix coordinate
 	 * @param myTemplate - My templated stats
 	 */
-	Player(const Coord& myPos, ActorTemplate& myTemplate) : ActorBase(FACTION::PLAYER, myPos, myTemplate), getDist(_pos) {}
+	Player(ActorStore& store, const Coord& myPos, ActorTemplate& myTemplate) : ActorBase(store, FACTION::PLAYER, myPos, myTemplate) {}
 };
 #pragma endregion	  ACTOR_PLAYER
 // NPC actors
@@ -632,11 +1018,10 @@ struct Player final : ActorBase {
  */
 struct NPC : ActorBase {
 private:
-	int
-		_MAX_AGGRO,		///< @brief Maximum aggression value
-		_aggro;			///< @brief Current aggression value
+	int _MAX_AGGRO;		///< @brief Maximum aggression value, the current value & target are kept in the store.
 protected:
-	ActorBase* _target; ///< @brief Current target, the NPC will attempt to move towards this actor and kill them.
+	PathCursor _path;	///< @brief The path this NPC is following towards its target.
+	LOD _lod{ LOD::Near }; ///< @brief The level-of-detail bucket this NPC was placed in the last time it acted.
 
 	/**
 	 * isAfraid()
@@ -646,10 +1031,10 @@ protected:
 	 */
 	[[nodiscard]] bool afraid() const
 	{
-		return static_cast<float>(_health) < static_cast<float>(_MAX_HEALTH) / 5.0f || static_cast<float>(_stamina) <
-			static_cast<float>(_MAX_STAMINA) / 6.0f;
+		return static_cast<float>(getHealth()) < static_cast<float>(getMaxHealth()) / 5.0f || static_cast<float>(getStamina()) <
+			static_cast<float>(getMaxStamina()) / 6.0f;
 	}
-	tRand _rng;
+	CounterRNG _rng;	///< @brief This NPC's own random number stream, seeded by the gamespace when the NPC is spawned.
 	/**
 	 * getDir(Coord&, bool)
 	 * @brief Returns a direction char from a start point and end point. Called from getDirTo()
@@ -724,16 +1109,17 @@ protected:
 	
 public:
 #pragma region DEF
-	NPC(const NPC&) = default;				///< @brief Default copy constructor.
+	NPC(const NPC&) = delete;				///< @brief Deleted, a copy would share the same components.
 	NPC(NPC&&) = default;					///< @brief Default move constructor.
 	virtual ~NPC() = default;				///< @brief Virtual destructor.
-	NPC& operator=(const NPC&) = default;	///< @brief Default copy operator.
+	NPC& operator=(const NPC&) = delete;	///< @brief Deleted, a copy would share the same components.
 	NPC& operator=(NPC&&) = default;		///< @brief Default move operator.
 #pragma endregion DEF
 
 	/**
-	 * NPC(FACTION, string&, Coord&, char, unsigned short, ActorStats&, int)
+	 * NPC(ActorStore&, FACTION, string&, Coord&, char, unsigned short, ActorStats&, int)
 	 * @brief Constructor that requires all values to be given an instantiation.
+	 * @param store			- The store to create this NPC's components in.
 	 * @param myFaction		- This NPC's faction.
 	 * @param myName		- This NPC's name.
 	 * @param myPos			- This NPC's position.
@@ -742,15 +1128,16 @@ public:
 	 * @param myStats		- This NPC's stats.
 	 * @param MAX_AGGRO		- This NPC's maximum aggression value.
 	 */
-	NPC(const FACTION myFaction, const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const ActorStats& myStats, const int MAX_AGGRO) : ActorBase(myFaction, myName, myPos, myChar, myColor, myStats), _MAX_AGGRO(MAX_AGGRO), _aggro(0), _target(nullptr) {}
+	NPC(ActorStore& store, const FACTION myFaction, const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const ActorStats& myStats, const int MAX_AGGRO) : ActorBase(store, myFaction, myName, myPos, myChar, myColor, myStats), _MAX_AGGRO(MAX_AGGRO), _path() {}
 	/**
-	 * NPC(FACTION, string&, Coord&, char, unsigned short, ActorStats&, int)
+	 * NPC(ActorStore&, FACTION, Coord&, ActorTemplate&)
 	 * @brief Constructor that takes a ref to an ActorTemplate instance.
+	 * @param store			- The store to create this NPC's components in.
 	 * @param myFaction		- This NPC's faction.
 	 * @param myPos			- This NPC's position.
 	 * @param myTemplate	- This NPC's templated stats.
 	 */
-	NPC(const FACTION myFaction, const Coord& myPos, ActorTemplate& myTemplate) : ActorBase(myFaction, myPos, myTemplate), _MAX_AGGRO(myTemplate._max_aggression), _aggro(0), _target(nullptr) {}
+	NPC(ActorStore& store, const FACTION myFaction, const Coord& myPos, ActorTemplate& myTemplate) : ActorBase(store, myFaction, myPos, myTemplate), _MAX_AGGRO(myTemplate._max_aggression), _path() {}
 
 #pragma region CAN_SEE
 	/**
@@ -760,7 +1147,7 @@ public:
 	 * @param visMod	- (Default: 0) Modifier to NPC visibility, this value is added to NPC's sight range.
 	 * @returns bool	- ( true = pos is within this NPC's visibility range ) ( false = pos is not visible )
 	 */
-	[[nodiscard]] bool canSee(const Coord& pos, const int visMod = 0) const { return checkDistance::get(_target->pos(), pos, _visRange + visMod); }
+	[[nodiscard]] bool canSee(const Coord& pos, const int visMod = 0) const { return checkDistance::get(getTarget()->pos(), pos, getVis() + visMod); }
 
 	/**
 	 * canSee(ActorBase*, int)
@@ -769,7 +1156,7 @@ public:
 	 * @param visMod	- (Default: 0) Modifier to NPC visibility, this value is added to NPC's sight range.
 	 * @returns bool	- ( true = NPC's target is within its visibility range ) ( false = NPC cannot see its target )
 	 */
-	[[nodiscard]] bool canSeeHostile(ActorBase* target, const int visMod = 0) { return isHostileTo(&*target) && checkDistance::get(target->pos(), _pos, _visRange + visMod); }
+	[[nodiscard]] bool canSeeHostile(ActorBase* target, const int visMod = 0) { return isHostileTo(&*target) && checkDistance::get(target->pos(), pos(), getVis() + visMod); }
 
 	/**
 	 * canSee(int)
@@ -777,7 +1164,11 @@ public:
 	 * @param visMod	- (Default: 0) Modifier to NPC visibility, this value is added to NPC's sight range.
 	 * @returns bool	- ( true = NPC's target is within its visibility range ) ( false = NPC cannot see its target )
 	 */
-	[[nodiscard]] bool canSeeTarget(const int visMod = 0) const { return _target != nullptr && checkDistance::get(_target->pos(), _pos, _visRange + visMod); }
+	[[nodiscard]] bool canSeeTarget(const int visMod = 0) const
+	{
+		const auto* target{ getTarget() };
+		return target != nullptr && checkDistance::get(target->pos(), pos(), getVis() + visMod);
+	}
 #pragma endregion CAN_SEE
 #pragma region DIRECTIONS
 	/**
@@ -787,7 +1178,7 @@ public:
 	 * @param noFear	- (Default: false) When true, NPC will never run away
 	 * @returns char	- w = up/s = down/a = left/d = right
 	 */
-	[[nodiscard]] char getDirTo(const Coord& target, const bool noFear = false) const { return getDir({ _pos._x - target._x, _pos._y - target._y }, noFear ? false : afraid()); }
+	[[nodiscard]] char getDirTo(const Coord& target, const bool noFear = false) const { return getDir({ pos()._x - target._x, pos()._y - target._y }, noFear ? false : afraid()); }
 
 	/**
 	 * getDirTo(ActorBase*)
@@ -799,7 +1190,7 @@ public:
 	[[nodiscard]] char getDirTo(ActorBase* target, const bool noFear = false) const
 	{
 		if ( target != nullptr )
-			return getDir({ _pos._x - target->pos()._x, _pos._y - target->pos()._y }, noFear ? false : afraid());
+			return getDir({ pos()._x - target->pos()._x, pos()._y - target->pos()._y }, noFear ? false : afraid());
 		return ' ';
 	}
 
@@ -809,12 +1200,17 @@ public:
 	 * @param noFear	- (Default: false) When true, NPC will never run away
 	 * @returns char	- w = up/s = down/a = left/d = right
 	 */
-	[[nodiscard]] char getDirTo(const bool noFear = false) const { return (_target != nullptr ? getDir({ _pos._x - _target->pos()._x, _pos._y - _target->pos()._y }, noFear ? false : afraid()) : ' '); }
+	[[nodiscard]] char getDirTo(const bool noFear = false) const
+	{
+		const auto* target{ getTarget() };
+		return target != nullptr ? getDir({ pos()._x - target->pos()._x, pos()._y - target->pos()._y }, noFear ? false : afraid()) : ' ';
+	}
+	[[nodiscard]] bool isAfraid() const { return afraid(); } ///< @brief Check if this NPC's stats are too low to continue fighting. @return true - NPC should run away. @return false - NPC is not afraid.
 #pragma endregion DIRECTIONS
 #pragma region AGGRESSION
-	[[nodiscard]] bool isAggro() const { return _aggro > 0; } ///< @brief Check if this NPC is aggravated. @return true - NPC is aggravated. @return false - NPC is not aggravated.
+	[[nodiscard]] bool isAggro() const { return _store->_aggro[_id] > 0; } ///< @brief Check if this NPC is aggravated. @return true - NPC is aggravated. @return false - NPC is not aggravated.
 	
-	[[nodiscard]] int getAggro() const { return _aggro; } ///< @brief Returns a copy of this NPC's current aggression value. @returns int
+	[[nodiscard]] int getAggro() const { return _store->_aggro[_id]; } ///< @brief Returns a copy of this NPC's current aggression value. @returns int
 	
 	/**
 	 * modAggro(int)
@@ -823,15 +1219,15 @@ public:
 	 */
 	void modAggro(const int modValue)
 	{
-		auto newValue{ _aggro + modValue };
+		auto newValue{ _store->_aggro[_id] + modValue };
 		if ( newValue < 0 )
 			newValue = 0;
 		if ( newValue > _MAX_AGGRO )
 			newValue = _MAX_AGGRO;
-		_aggro = newValue;
+		_store->_aggro[_id] = newValue;
 	}
 	
-	void maxAggro() { _aggro = _MAX_AGGRO; } ///< @brief Sets this NPC's aggression to maximum, does not check for targets.
+	void maxAggro() { _store->_aggro[_id] = _MAX_AGGRO; } ///< @brief Sets this NPC's aggression to maximum, does not check for targets.
 	
 	/**
 	 * maxAggro()
@@ -843,7 +1239,7 @@ public:
 	{
 		// If target was set successfully, set aggression to max & return true
 		if ( setTarget(target) ) {
-			_aggro = _MAX_AGGRO;
+			_store->_aggro[_id] = _MAX_AGGRO;
 			return true;
 		}
 		return false;
@@ -853,25 +1249,25 @@ public:
 	 * removeAggro()
 	 * @brief Sets this NPC's aggression to 0, and sets target to nullptr.
 	 */
-	void removeAggro() { _aggro = 0; removeTarget(); }
+	void removeAggro() { _store->_aggro[_id] = 0; removeTarget(); }
 	
 	/**
 	 * decrementAggro()
 	 * @brief Decreases this NPC's aggression by 1.
 	 */
-	void decrementAggro() { if ( _aggro > 0 ) --_aggro; }
+	void decrementAggro() { if ( _store->_aggro[_id] > 0 ) --_store->_aggro[_id]; }
 #pragma endregion AGGRESSION
 #pragma region TARGET
 	/**
 	 * hasTarget()
-	 * @brief Checks if this NPC has a target. If NPC's target is dead, this function removes their target & returns false.
+	 * @brief Checks if this NPC has a target. If NPC's target is dead or was removed, this function removes their target & returns false.
 	 * @returns bool	- ( true = NPC has a valid target ) ( false = NPC does not have a target )
 	 */
 	[[nodiscard]] bool hasTarget()
 	{
-		if ( _target == nullptr )
+		if ( _store->_target[_id].empty() )
 			return false;
-		if ( _target->isDead() ) { // if NPC's target is dead, remove target & return false
+		if ( const auto* target{ getTarget() }; target == nullptr || target->isDead() ) { // the target's handle expired, or it is dead
 			removeTarget();
 			return false;
 		}
@@ -880,10 +1276,10 @@ public:
 	
 	/**
 	 * getTarget()
-	 * @brief Returns a pointer to this NPC's target.
-	 * @returns ActorBase*	- ( nullptr = NPC does not have a target. )
+	 * @brief Returns a pointer to this NPC's target, resolved from its handle.
+	 * @returns ActorBase*	- ( nullptr = NPC does not have a target, or the target was removed. )
 	 */
-	[[nodiscard]] ActorBase* getTarget() const { return _target; }
+	[[nodiscard]] ActorBase* getTarget() const { return _store->resolve(_store->_target[_id]); }
 
 	/**
 	 * setTarget(ActorBase*)
@@ -894,24 +1290,42 @@ public:
 	[[nodiscard]] bool setTarget(ActorBase* target)
 	{
 		// don't set target if the given target is from the same faction
-		if ( target->faction() == _faction )
+		if ( target->faction() == faction() )
 			return false;
-		// if there is already a target set, remove it first
-		if ( _target != nullptr ) _target = nullptr;
 		// if NPC is not hostile to the target's faction, make them hostile to it
 		if ( !isHostileTo(target->faction()) )
 			setRelationship(target->faction(), true);
 		// set the target
-		_target = target;
+		_store->_target[_id] = target->handle();
+		_path.clear();
 		return true;
 	}
 	
 	/**
 	 * removeTarget()
-	 * @brief Sets this NPC's target to nullptr.
+	 * @brief Clears this NPC's target.
+	 */
+	void removeTarget() { _store->_target[_id] = {}; _path.clear(); }
+
+	/**
+	 * path()
+	 * @brief Returns a reference to the path this NPC is following towards its target.
+	 * @returns PathCursor&
+	 */
+	[[nodiscard]] PathCursor& path() { return _path; }
+
+	/**
+	 * rng()
+	 * @brief Returns a reference to this NPC's random number stream. Random decisions made for this NPC should draw from it, so they don't depend on the order other NPCs act in.
+	 * @returns CounterRNG&
 	 */
-	void removeTarget() { _target = nullptr; }
+	[[nodiscard]] CounterRNG& rng() { return _rng; }
 #pragma endregion TARGET
+#pragma region LOD
+	[[nodiscard]] LOD lod() const { return _lod; } ///< @brief Returns this NPC's level-of-detail bucket. @returns LOD
+	void setLOD(const LOD bucket) { _lod = bucket; } ///< @brief Sets this NPC's level-of-detail bucket. @param bucket - The new bucket.
+	void promote() { _lod = LOD::Near; } ///< @brief Moves this NPC to the Near bucket, so it acts during the next NPC cycle. Call this when an event involves the NPC.
+#pragma endregion LOD
 };
 /**
  * @struct Enemy
@@ -919,8 +1333,9 @@ public:
  */
 struct Enemy final : NPC {
 	/** CONSTRUCTOR **
-	 * Enemy(string, Coord, char, unsigned short, int, int, int, int, int)
+	 * Enemy(ActorStore&, string, Coord, char, unsigned short, int, int, int, int, int)
 	 * @brief Constructs an enemy with the given parameters.
+	 * @param store		 - The store to create my components in.
 	 * @param myName	 - My reporting name.
 	 * @param myPos		 - My current position as a matrix coordinate
 	 * @param myChar	 - My display character when inserted into a stream
@@ -932,11 +1347,12 @@ struct Enemy final : NPC {
 	 * @param myVisRange - My sight range
 	 * @param MAX_AGGRO  - My maximum aggression
 	 */
-	Enemy(const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const int myLevel, const int myHealth, const int myStamina, const int myDamage, const int myVisRange, const int MAX_AGGRO) : NPC(FACTION::ENEMY, myName, myPos, myChar, myColor, ActorStats(myLevel, myHealth, myStamina, myDamage, myVisRange), MAX_AGGRO) {}
+	Enemy(ActorStore& store, const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const int myLevel, const int myHealth, const int myStamina, const int myDamage, const int myVisRange, const int MAX_AGGRO) : NPC(store, FACTION::ENEMY, myName, myPos, myChar, myColor, ActorStats(myLevel, myHealth, myStamina, myDamage, myVisRange), MAX_AGGRO) {}
 	
 	/** CONSTRUCTOR **
-	 * Enemy(string, Coord, char, unsigned short, ActorStats&)
+	 * Enemy(ActorStore&, string, Coord, char, unsigned short, ActorStats&)
 	 * @brief Constructs an enemy from an ActorStats instance.
+	 * @param store		 - The store to create my components in.
 	 * @param myName	- My reporting name.
 	 * @param myPos		- My current position as a matrix coordinate
 	 * @param myChar	- My display character when inserted into a stream
@@ -944,17 +1360,18 @@ struct Enemy final : NPC {
 	 * @param myStats	- A ref to my base statistics object
 	 * @param MAX_AGGRO	- My maximum aggression
 	 */
-	Enemy(const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const ActorStats
+	Enemy(ActorStore& store, const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const ActorStats
 		&
-		myStats, const int MAX_AGGRO) : NPC(FACTION::ENEMY, myName, myPos, myChar, myColor, myStats, MAX_AGGRO) {}
+		myStats, const int MAX_AGGRO) : NPC(store, FACTION::ENEMY, myName, myPos, myChar, myColor, myStats, MAX_AGGRO) {}
 
 	/** CONSTRUCTOR **
-	 * Enemy(Coord&, ActorTemplate&)
+	 * Enemy(ActorStore&, Coord&, ActorTemplate&)
 	 * @brief Construct an enemy from an ActorTemplate instance.
+	 * @param store		 - The store to create my components in.
 	 * @param myPos			- My current position as a matrix coordinate
 	 * @param myTemplate	- My templated stats
 	 */
-	Enemy(const Coord& myPos, ActorTemplate& myTemplate) : NPC(FACTION::ENEMY, myPos, myTemplate) {}
+	Enemy(ActorStore& store, const Coord& myPos, ActorTemplate& myTemplate) : NPC(store, FACTION::ENEMY, myPos, myTemplate) {}
 };
 /**
  * @struct Neutral
@@ -962,8 +1379,9 @@ struct Enemy final : NPC {
  */
 struct Neutral final : NPC {
 	/** CONSTRUCTOR **
-	 * Neutral(string, Coord, char, unsigned short, int, int, int, int, int)
+	 * Neutral(ActorStore&, string, Coord, char, unsigned short, int, int, int, int, int)
 	 * @brief Constructs a neutral NPC with the given stats.
+	 * @param store		 - The store to create my components in.
 	 * @param myName	 - My reporting name.
 	 * @param myPos		 - My current position as a matrix coordinate
 	 * @param myChar	 - My display character when inserted into a stream
@@ -975,11 +1393,12 @@ struct Neutral final : NPC {
 	 * @param myVisRange - My sight range
 	 * @param MAX_AGGRO	 - My maximum possible aggression
 	 */
-	Neutral(const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const int myLevel, const int myHealth, const int myStamina, const int myDamage, const int myVisRange, const int MAX_AGGRO) : NPC(FACTION::NEUTRAL, myName, myPos, myChar, myColor, ActorStats(myLevel, myHealth, myStamina, myDamage, myVisRange), MAX_AGGRO) {}
+	Neutral(ActorStore& store, const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const int myLevel, const int myHealth, const int myStamina, const int myDamage, const int myVisRange, const int MAX_AGGRO) : NPC(store, FACTION::NEUTRAL, myName, myPos, myChar, myColor, ActorStats(myLevel, myHealth, myStamina, myDamage, myVisRange), MAX_AGGRO) {}
 
 	/** CONSTRUCTOR **
-	 * Neutral(string&, Coord&, char, unsigned short, ActorStats&, int)
+	 * Neutral(ActorStore&, string&, Coord&, char, unsigned short, ActorStats&, int)
 	 * @brief Constructs a neutral NPC from an ActorStats instance.
+	 * @param store		 - The store to create my components in.
 	 * @param myName	 - My reporting name.
 	 * @param myPos		 - My current position as a matrix coordinate
 	 * @param myChar	 - My display character when inserted into a stream
@@ -987,15 +1406,16 @@ struct Neutral final : NPC {
 	 * @param myStats	 - My stat instance
 	 * @param MAX_AGGRO	 - My maximum possible aggression
 	 */
-	Neutral(const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const ActorStats
-		& myStats, const int MAX_AGGRO) : NPC(FACTION::NEUTRAL, myName, myPos, myChar, myColor, myStats, MAX_AGGRO) {}
+	Neutral(ActorStore& store, const std::string& myName, const Coord& myPos, const char myChar, const unsigned short myColor, const ActorStats
+		& myStats, const int MAX_AGGRO) : NPC(store, FACTION::NEUTRAL, myName, myPos, myChar, myColor, myStats, MAX_AGGRO) {}
 
 	/** CONSTRUCTOR **
-	 * Neutral(Coord&, ActorTemplate&)
+	 * Neutral(ActorStore&, Coord&, ActorTemplate&)
 	 * @brief Constructs a neutral NPC from an ActorTemplate instance.
+	 * @param store		 - The store to create my components in.
 	 * @param myPos			- My current position as a matrix coordinate
 	 * @param myTemplate	- My templated stats
 	 */
-	Neutral(const Coord& myPos, ActorTemplate& myTemplate) : NPC(FACTION::NEUTRAL, myPos, myTemplate) {}
+	Neutral(ActorStore& store, const Coord& myPos, ActorTemplate& myTemplate) : NPC(store, FACTION::NEUTRAL, myPos, myTemplate) {}
 };
 #pragma endregion		  ACTOR_NPC
\ No newline at end of file
@@ -0,0 +1,205 @@
+/**
+ * @file bitplane.h
+ * @author radj307
+ * @brief Contains the BitPlane class, a packed 2-D matrix of boolean flags.
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Coord.h"
+
+/**
+ * @class BitPlane
+ * @brief Stores one boolean trait for every position in a 2-D matrix, packed into 64-bit words. \n
+ * Each row starts on a word boundary, so a row can be processed a whole word at a time without having to handle a bit offset. \n
+ * Bits past the end of a row are always kept at zero.
+ */
+class BitPlane final {
+public:
+	using word = std::uint64_t;					///< @brief The storage word type.
+	static constexpr long WORD_BITS{ 64 };		///< @brief The number of bits in a single storage word.
+
+private:
+	long _width{ 0 };				///< @brief The number of columns in each row.
+	long _height{ 0 };				///< @brief The number of rows.
+	size_t _stride{ 0u };			///< @brief The number of words in each row.
+	std::vector<word> _words;		///< @brief Packed storage, in row-major order.
+
+	/**
+	 * tailMask()
+	 * @brief Returns a mask of the bits in the last word of a row that are within the row's width.
+	 * @returns word
+	 */
+	[[nodiscard]] word tailMask() const noexcept
+	{
+		const auto used{ _width % WORD_BITS };
+		return used == 0 ? ~word{ 0 } : ( word{ 1 } << used ) - 1u;
+	}
+
+public:
+	/**
+	 * BitPlane()
+	 * @brief Default constructor, creates an empty plane.
+	 */
+	BitPlane() = default;
+
+	/**
+	 * BitPlane(Coord&, bool)
+	 * @brief Create a bitplane of the given size.
+	 * @param size	- The number of columns (_x) & rows (_y).
+	 * @param init	- (Default: false) The initial value of every bit.
+	 */
+	explicit BitPlane( const Coord& size, const bool init = false ) : _width( size._x > 0 ? size._x : 0 ), _height( size._y > 0 ? size._y : 0 ), _stride( static_cast<size_t>( ( _width + WORD_BITS - 1 ) / WORD_BITS ) ), _words( _stride * static_cast<size_t>(_height), word{ 0 } )
+	{
+		if ( init )
+			fill( true );
+	}
+
+	/**
+	 * get(long, long)
+	 * @brief Returns the value of a single bit. Does not check boundaries.
+	 * @param x		- X-axis (horizontal) index.
+	 * @param y		- Y-axis (vertical) index.
+	 * @returns bool
+	 */
+	[[nodiscard]] bool get( const long x, const long y ) const noexcept { return ( row( y )[x / WORD_BITS] >> ( x % WORD_BITS ) & 1u ) != 0u; }
+
+	/**
+	 * set(long, long, bool)
+	 * @brief Sets the value of a single bit. Does not check boundaries.
+	 * @param x		- X-axis (horizontal) index.
+	 * @param y		- Y-axis (vertical) index.
+	 * @param to	- The new value.
+	 */
+	void set( const long x, const long y, const bool to ) noexcept
+	{
+		auto& w{ row( y )[x / WORD_BITS] };
+		const auto bit{ word{ 1 } << ( x % WORD_BITS ) };
+		if ( to )
+			w |= bit;
+		else
+			w &= ~bit;
+	}
+
+	/**
+	 * fill(bool)
+	 * @brief Sets every bit in the plane to the given value.
+	 * @param to	- The new value.
+	 */
+	void fill( const bool to ) noexcept
+	{
+		if ( !to ) {
+			clear();
+			return;
+		}
+		std::fill( _words.begin(), _words.end(), ~word{ 0 } );
+		if ( _stride > 0u ) // keep the bits past the end of each row clear
+			for ( long y{ 0 }; y < _height; ++y )
+				row( y )[_stride - 1u] &= tailMask();
+	}
+
+	/**
+	 * clear()
+	 * @brief Sets every bit in the plane to false.
+	 */
+	void clear() noexcept
+	{
+		if ( !_words.empty() )
+			std::memset( _words.data(), 0, _words.size() * sizeof( word ) );
+	}
+
+	/**
+	 * assign(BitPlane&)
+	 * @brief Copies the contents of another plane of the same size into this one.
+	 * @param other	- The plane to copy from, this must have the same dimensions as this plane.
+	 */
+	void assign( const BitPlane& other ) noexcept
+	{
+		if ( !_words.empty() && other._words.size() == _words.size() )
+			std::memcpy( _words.data(), other._words.data(), _words.size() * sizeof( word ) );
+	}
+
+	/**
+	 * rangeMask(long, long)
+	 * @brief Returns a word with the bits from first to last (inclusive) set.
+	 * @param first	- Index of the first bit, must be in the range [0, WORD_BITS).
+	 * @param last	- Index of the last bit, must be in the range [first, WORD_BITS).
+	 * @returns word
+	 */
+	[[nodiscard]] static constexpr word rangeMask( const long first, const long last ) noexcept { return ~word{ 0 } >> ( WORD_BITS - 1 - last ) & ~word{ 0 } << first; }
+
+	/**
+	 * setRange(long, long, long, bool)
+	 * @brief Sets a horizontal run of bits in a single row to the given value, a whole word at a time. Does not check boundaries.
+	 * @param y		- Y-axis (vertical) index of the row.
+	 * @param x0	- X-axis (horizontal) index of the first bit.
+	 * @param x1	- X-axis (horizontal) index of the last bit (inclusive).
+	 * @param to	- The new value.
+	 */
+	void setRange( const long y, const long x0, const long x1, const bool to ) noexcept
+	{
+		auto* const r{ row( y ) };
+		for ( auto w{ x0 / WORD_BITS }, last{ x1 / WORD_BITS }; w <= last && x0 <= x1; ++w ) {
+			const auto mask{ rangeMask( w == x0 / WORD_BITS ? x0 % WORD_BITS : 0, w == last ? x1 % WORD_BITS : WORD_BITS - 1 ) };
+			if ( to )
+				r[w] |= mask;
+			else
+				r[w] &= ~mask;
+		}
+	}
+
+	/**
+	 * copyRange(long, long, long, BitPlane&)
+	 * @brief Copies a horizontal run of bits in a single row from another plane of the same size, a whole word at a time. Does not check boundaries.
+	 * @param y		- Y-axis (vertical) index of the row.
+	 * @param x0	- X-axis (horizontal) index of the first bit.
+	 * @param x1	- X-axis (horizontal) index of the last bit (inclusive).
+	 * @param src	- The plane to copy bits from.
+	 */
+	void copyRange( const long y, const long x0, const long x1, const BitPlane& src ) noexcept
+	{
+		auto* const r{ row( y ) };
+		const auto* const s{ src.row( y ) };
+		for ( auto w{ x0 / WORD_BITS }, last{ x1 / WORD_BITS }; w <= last && x0 <= x1; ++w ) {
+			const auto mask{ rangeMask( w == x0 / WORD_BITS ? x0 % WORD_BITS : 0, w == last ? x1 % WORD_BITS : WORD_BITS - 1 ) };
+			r[w] = ( r[w] & ~mask ) | ( s[w] & mask );
+		}
+	}
+
+	/**
+	 * row(long)
+	 * @brief Returns a pointer to the first word of a row. Does not check boundaries.
+	 * @param y		- Y-axis (vertical) index.
+	 * @returns word*
+	 */
+	[[nodiscard]] word* row( const long y ) noexcept { return _words.data() + static_cast<size_t>(y) * _stride; }
+	/**
+	 * row(long)
+	 * @brief Returns a pointer to the first word of a row. Does not check boundaries.
+	 * @param y		- Y-axis (vertical) index.
+	 * @returns const word*
+	 */
+	[[nodiscard]] const word* row( const long y ) const noexcept { return _words.data() + static_cast<size_t>(y) * _stride; }
+
+	/**
+	 * stride()
+	 * @brief Returns the number of words in each row.
+	 * @returns size_t
+	 */
+	[[nodiscard]] size_t stride() const noexcept { return _stride; }
+	/**
+	 * width()
+	 * @brief Returns the number of columns in each row.
+	 * @returns long
+	 */
+	[[nodiscard]] long width() const noexcept { return _width; }
+	/**
+	 * height()
+	 * @brief Returns the number of rows.
+	 * @returns long
+	 */
+	[[nodiscard]] long height() const noexcept { return _height; }
+};
@@ -6,14 +6,19 @@
  */
 // ReSharper disable CppClangTidyClangDiagnosticDocumentationUnknownCommand
 #pragma once
+#include <optional>
 #include <vector>
-#include <xRand.h>
 
+#include "bitplane.h"
 #include "Coord.h"
+#include "fov.h"
+#include "rng.h"
+#include "span.h"
 
 /**
  * @struct Tile
  * @brief Represents a single position in the matrix of a cell. \n
+ * The cell does not store Tile instances directly, this is used to describe a tile when generating the cell, and as a snapshot of a tile returned by Cell::get().
  */
 struct Tile final {
 private:
@@ -41,7 +46,7 @@ public:
 	 * @enum display
 	 * @brief Defines valid tile types/display characters.
 	 */
-	enum class display {
+	enum class display : char {
 		empty = '_',
 		wall = '#',
 		hole = 'O',
@@ -67,17 +72,50 @@ public:
  * @class Cell
  * @brief Represents the environment of the gamespace. \n
  * The cell contains the tile matrix, it does not have any knowledge of the gamespace or entities located within it. \n
- * The cell does not have the ability to display itself to the console.
+ * The cell does not have the ability to display itself to the console. \n
+ * Tiles are stored in structure-of-arrays form; the display type of every tile is kept in a single contiguous row-major array, and each tile trait is kept in its own BitPlane.
  */
 class Cell final {
-	using row = std::vector<Tile>;	///< @brief A single vector of Tile instances.
-	using cell = std::vector<row>;	///< @brief A vector of row instances, which creates a 2-D matrix.
-
-	cell _matrix;	///< @brief Tile matrix
+	std::vector<Tile::display> _display;	///< @brief Display type of each tile, in row-major order.
+	BitPlane
+		_known,			///< @brief Tile::_isKnown of each tile.
+		_can_move,		///< @brief Tile::_canMove of each tile.
+		_is_trap,		///< @brief Tile::_isTrap of each tile.
+		_can_spawn,		///< @brief Tile::_canSpawn of each tile.
+		_wall;			///< @brief Set for each tile with the wall display type.
+	unsigned _wall_version{ 0u };			///< @brief Incremented whenever the wall plane changes, used to invalidate cached field of view results.
+	unsigned _move_version{ 0u };			///< @brief Incremented whenever the canMove plane changes, used to invalidate pathfinding data.
+	FieldOfView _fov;						///< @brief Field of view calculator & cache, operates on the wall plane.
 	bool // These booleans determine the visibility of specific tile types when the game starts.
 		_vis_all,	///< @brief Determines if the player can see all Tile instances when the game starts.
 		_vis_wall;	///< @brief Determines if the player can see all Tile instances that are walls when the game starts.
 
+	/**
+	 * index(long, long)
+	 * @brief Returns the row-major index of a given position in the display array. Does not check boundaries.
+	 * @param x		- X-axis (horizontal) index.
+	 * @param y		- Y-axis (vertical) index.
+	 * @returns size_t
+	 */
+	[[nodiscard]] size_t index( const long x, const long y ) const noexcept { return static_cast<size_t>(y) * static_cast<size_t>(_max._x) + static_cast<size_t>(x); }
+
+	/**
+	 * setTile(long, long, Tile&)
+	 * @brief Overwrites the display type & all traits of a given position. Does not check boundaries.
+	 * @param x		- X-axis (horizontal) index.
+	 * @param y		- Y-axis (vertical) index.
+	 * @param tile	- The tile to store at this position.
+	 */
+	void setTile( const long x, const long y, const Tile& tile ) noexcept
+	{
+		_display[index( x, y )] = tile._display;
+		_known.set( x, y, tile._isKnown );
+		_can_move.set( x, y, tile._canMove );
+		_is_trap.set( x, y, tile._isTrap );
+		_can_spawn.set( x, y, tile._canSpawn );
+		_wall.set( x, y, tile._display == Tile::display::wall );
+	}
+
 	/**
 	 * isAdjacent(Tile::display, Coord&)
 	 * @brief Checks the tiles surrounding a given position for a target type.
@@ -90,55 +128,146 @@ class Cell final {
 	{
 		for ( auto y{ pos._y - 1 }; y <= pos._y + 1; ++y )
 			for ( auto x{ pos._x - 1 }; x <= pos._x + 1; ++x )
-				if ( isValidPos( x, y ) && get( x, y )->_display == type && !( x == pos._x && y == pos._y ) )
+				if ( isValidPos( x, y ) && _display[index( x, y )] == type && !( x == pos._x && y == pos._y ) )
 					return true;
 		return false;
 	}
 
 	/**
-	 * generate()
-	 * @brief Randomly generates the Tile matrix using the xRand.h lib.
+	 * generate(CounterRNG)
+	 * @brief Randomly generates the Tile matrix.
+	 * @param rng	- The random number stream to generate the cell from. The same stream always generates the same cell.
 	 */
-	void generate()
+	void generate( CounterRNG rng )
 	{
-		_matrix.reserve( _max._y );
+		_display.assign( static_cast<size_t>(_max._x > 0 ? _max._x : 0) * static_cast<size_t>(_max._y > 0 ? _max._y : 0), Tile::display::none );
+		_known = BitPlane{ _max };
+		_can_move = BitPlane{ _max };
+		_is_trap = BitPlane{ _max };
+		_can_spawn = BitPlane{ _max };
+		_wall = BitPlane{ _max };
 		if ( _max._y >= 10 && _max._x >= 10 ) {
-			tRand rng;
 			for ( auto y = 0; y < _max._y; y++ ) {
-				row row;
-				row.reserve( _max._x );
 				for ( auto x = 0; x < _max._x; x++ ) {
 					// make walls on all edges
 					if ( x == 0 || x == _max._x - 1 || ( y == 0 || y == _max._y - 1 ) )
-						row.push_back( { Tile::display::wall, _vis_wall || _vis_all } );
+						setTile( x, y, { Tile::display::wall, _vis_wall || _vis_all } );
 					else { // not an edge
 						const auto rand{ rng.get( 100.0f, 0.0f ) };
 						if ( rand < 7.0f ) // 7:100 chance of a wall tile that isn't on an edge
-							row.push_back( { Tile::display::wall, _vis_wall || _vis_all } );
+							setTile( x, y, { Tile::display::wall, _vis_wall || _vis_all } );
 						else if ( rand > 7.0f && rand < 9.0f )
-							row.push_back( { Tile::display::hole, _vis_all } );
+							setTile( x, y, { Tile::display::hole, _vis_all } );
 						else
-							row.push_back( { Tile::display::empty, _vis_all } );
+							setTile( x, y, { Tile::display::empty, _vis_all } );
 					}
 				}
-				_matrix.emplace_back( std::move( row ) );
 			}
 		}
 	}
 
+	/**
+	 * modVisUnchecked(bool, long, long)
+	 * @brief Modifies the visibility of a given Tile. Does not check boundaries.
+	 * @param to		- When true, Tile is set to visible.
+	 * @param X			- X-axis (horizontal) index.
+	 * @param Y			- Y-axis (vertical) index.
+	 */
+	void modVisUnchecked( const bool to, const long X, const long Y ) noexcept
+	{
+		_known.set( X, Y, to || ( _display[index( X, Y )] == Tile::display::wall ? _vis_wall : _vis_all ) );
+	}
+
+	/**
+	 * modVisRow(bool, long, long, long)
+	 * @brief Modifies the visibility of a horizontal run of tiles, a whole BitPlane word at a time. The run is clipped to the cell boundaries.
+	 * @param to	- When true, Tiles are set to visible.
+	 * @param y		- Y-axis (vertical) index of the row.
+	 * @param x0	- X-axis (horizontal) index of the first tile.
+	 * @param x1	- X-axis (horizontal) index of the last tile (inclusive).
+	 */
+	void modVisRow( const bool to, const long y, long x0, long x1 ) noexcept
+	{
+		if ( y < 0 || y >= _max._y )
+			return;
+		if ( x0 < 0 )
+			x0 = 0;
+		if ( x1 >= _max._x )
+			x1 = _max._x - 1;
+		if ( x0 > x1 )
+			return;
+		if ( to || _vis_all == _vis_wall ) // every tile in the run ends up with the same value
+			_known.setRange( y, x0, x1, to || _vis_all );
+		else if ( _vis_wall ) // only walls stay visible
+			_known.copyRange( y, x0, x1, _wall );
+		else
+			for ( auto x{ x0 }; x <= x1; ++x )
+				modVisUnchecked( to, x, y );
+	}
+
+	/**
+	 * forEachDifference(SpanList&, SpanList&, Func&&)
+	 * @brief Calls a function for each run of tiles that is covered by one span list, but not by another.
+	 * @tparam Func		- Function type, with the signature void(long y, long x0, long x1)
+	 * @param a			- The span list to iterate.
+	 * @param b			- The span list to subtract from a.
+	 * @param func		- The function to call for each run of tiles in (a - b).
+	 */
+	template<typename Func>
+	static void forEachDifference( const SpanList& a, const SpanList& b, Func&& func )
+	{
+		size_t j{ 0u };
+		for ( const auto& span : a ) {
+			// skip spans in b that are entirely before this span
+			while ( j < b.size() && ( b[j]._y < span._y || ( b[j]._y == span._y && b[j]._x1 < span._x0 ) ) )
+				++j;
+			auto x{ span._x0 };
+			for ( auto k{ j }; k < b.size() && b[k]._y == span._y && b[k]._x0 <= span._x1 && x <= span._x1; ++k ) {
+				if ( b[k]._x0 > x )
+					func( span._y, x, b[k]._x0 - 1 );
+				if ( b[k]._x1 >= x )
+					x = b[k]._x1 + 1;
+			}
+			if ( x <= span._x1 )
+				func( span._y, x, span._x1 );
+		}
+	}
+
+	/**
+	 * setDisplay(Coord&, Tile::display)
+	 * @brief Changes the type of a tile, and resets its traits to match the new type. The tile's visibility is kept. \n
+	 * This is private so that tiles are only changed through Gamespace::setTile(), which also updates everything in the gamespace that depends on the tile.
+	 * @param pos	- Target position
+	 * @param as	- The new tile type
+	 */
+	void setDisplay( const Coord& pos, const Tile::display as ) noexcept
+	{
+		if ( isValidPos( pos ) ) {
+			const auto wasWall{ _wall.get( pos._x, pos._y ) }, couldMove{ _can_move.get( pos._x, pos._y ) };
+			setTile( pos._x, pos._y, { as, _known.get( pos._x, pos._y ) } );
+			if ( wasWall != _wall.get( pos._x, pos._y ) )
+				++_wall_version; // walls changed, cached field of view results are no longer valid
+			if ( couldMove != _can_move.get( pos._x, pos._y ) )
+				++_move_version; // passability changed, pathfinding data is no longer valid
+		}
+	}
+
+	friend class Gamespace;
+
 public:
 	const Coord _max;	///< @brief This is the max point of the Cell, which is the bottom-right corner.
 	// ReSharper disable once CppInconsistentNaming
 	const checkBounds isValidPos; ///< @brief Functor that can be used to check if a point is within the boundaries of the Cell.
 
 	/**
-	 * Cell(Coord, bool)
+	 * Cell(Coord, bool, bool, CounterRNG)
 	 * @brief Generate a new cell with the given size parameters. Minimum size is 10x10
 	 * @param cellSize				- The size of the cell
 	 * @param makeWallsVisible		- walls are always visible
 	 * @param override_known_tiles	- When true, all tiles will be visible to the player from the start.
+	 * @param rng					- (Default: CounterRNG{}) The random number stream used to generate the cell.
 	 */
-	explicit Cell( const Coord& cellSize, const bool makeWallsVisible = true, const bool override_known_tiles = false ) noexcept : _vis_all( override_known_tiles ), _vis_wall( makeWallsVisible ), _max( cellSize._x - 1, cellSize._y - 1 ), isValidPos( _max ) { try { generate(); } catch ( ... ) {} }
+	explicit Cell( const Coord& cellSize, const bool makeWallsVisible = true, const bool override_known_tiles = false, const CounterRNG rng = CounterRNG{} ) noexcept : _vis_all( override_known_tiles ), _vis_wall( makeWallsVisible ), _max( cellSize._x - 1, cellSize._y - 1 ), isValidPos( _max ) { try { generate( rng ); } catch ( ... ) {} }
 
 	/**
 	 * getChar(Coord&)
@@ -147,7 +276,65 @@ public:
 	 * @return ' '	 - Invalid position
 	 * @returns char - The display char of the Tile located at the given position.
 	 */
-	char getChar( const Coord& pos ) noexcept { return isValidPos( pos ) ? static_cast<char>(get( pos )->_display) : ' '; }
+	char getChar( const Coord& pos ) noexcept { return isValidPos( pos ) ? getCharUnchecked( pos._x, pos._y ) : ' '; }
+
+	/**
+	 * getCharUnchecked(long, long)
+	 * @brief Returns the display character of a given Tile. Does not check boundaries, this is intended for loops that already iterate within the cell.
+	 * @param x		 - X-axis (horizontal) index.
+	 * @param y		 - Y-axis (vertical) index.
+	 * @returns char - The display char of the Tile located at the given position.
+	 */
+	[[nodiscard]] char getCharUnchecked( const long x, const long y ) const noexcept { return static_cast<char>(_display[index( x, y )]); }
+
+	/**
+	 * isKnownUnchecked(long, long)
+	 * @brief Returns true if a given Tile is visible to the player. Does not check boundaries, this is intended for loops that already iterate within the cell.
+	 * @param x		 - X-axis (horizontal) index.
+	 * @param y		 - Y-axis (vertical) index.
+	 * @returns bool
+	 */
+	[[nodiscard]] bool isKnownUnchecked( const long x, const long y ) const noexcept { return _known.get( x, y ); }
+
+	/**
+	 * isKnown(Coord&)
+	 * @brief Returns true if a given Tile is visible to the player.
+	 * @param pos	 - Target position
+	 * @returns bool - False if the position is invalid.
+	 */
+	[[nodiscard]] bool isKnown( const Coord& pos ) const noexcept { return isValidPos( pos ) && _known.get( pos._x, pos._y ); }
+
+	/**
+	 * canMove(Coord&)
+	 * @brief Returns true if actors can move to a given Tile. Does not check for actors.
+	 * @param pos	 - Target position
+	 * @returns bool - False if the position is invalid.
+	 */
+	[[nodiscard]] bool canMove( const Coord& pos ) const noexcept { return isValidPos( pos ) && _can_move.get( pos._x, pos._y ); }
+	/**
+	 * canMove(long, long)
+	 * @brief Returns true if actors can move to a given Tile. Does not check for actors.
+	 * @param x		 - X-axis (horizontal) index.
+	 * @param y		 - Y-axis (vertical) index.
+	 * @returns bool - False if the position is invalid.
+	 */
+	[[nodiscard]] bool canMove( const long x, const long y ) const noexcept { return isValidPos( x, y ) && _can_move.get( x, y ); }
+
+	/**
+	 * isTrap(Coord&)
+	 * @brief Returns true if a given Tile is a trap.
+	 * @param pos	 - Target position
+	 * @returns bool - False if the position is invalid.
+	 */
+	[[nodiscard]] bool isTrap( const Coord& pos ) const noexcept { return isValidPos( pos ) && _is_trap.get( pos._x, pos._y ); }
+
+	/**
+	 * canSpawn(Coord&)
+	 * @brief Returns true if entities are allowed to spawn on a given Tile.
+	 * @param pos	 - Target position
+	 * @returns bool - False if the position is invalid.
+	 */
+	[[nodiscard]] bool canSpawn( const Coord& pos ) const noexcept { return isValidPos( pos ) && _can_spawn.get( pos._x, pos._y ); }
 
 	/**
 	 * modVis(bool)
@@ -156,14 +343,14 @@ public:
 	 */
 	void modVis( const bool to ) noexcept
 	{
-		if ( !_vis_all || to )
-			for ( auto& y : _matrix )
-				for ( auto& x : y ) {
-					if ( x._display == Tile::display::wall )
-						x._isKnown = to || _vis_wall;
-					else
-						x._isKnown = to;
-				}
+		if ( to )
+			_known.fill( true );
+		else if ( !_vis_all ) {
+			if ( _vis_wall ) // walls stay visible
+				_known.assign( _wall );
+			else
+				_known.clear();
+		}
 	}
 
 	/**
@@ -175,12 +362,8 @@ public:
 	 */
 	void modVis( const bool to, const long X, const long Y ) noexcept
 	{
-		if ( isValidPos( X, Y ) ) {
-			if ( _matrix.at( Y ).at( X )._display != Tile::display::wall )
-				_matrix.at( Y ).at( X )._isKnown = to || _vis_all;
-			else
-				_matrix.at( Y ).at( X )._isKnown = to || _vis_wall;
-		}
+		if ( isValidPos( X, Y ) )
+			modVisUnchecked( to, X, Y );
 	}
 
 	/**
@@ -193,14 +376,14 @@ public:
 	void modVis( const bool to, const Coord& pos, const int radius ) noexcept
 	{
 		if ( !_vis_all || to )
-			for ( int y = pos._y - radius; y <= pos._y + radius; y++ )
-				for ( int x = pos._x - radius; x <= pos._x + radius; x++ )
-					modVis( to, x, y );
+			for ( auto y{ pos._y - radius }; y <= pos._y + radius; y++ )
+				modVisRow( to, y, pos._x - radius, pos._x + radius );
 	}
 
 	/**
 	 * modVis(bool, Coord, const int)
-	 * @brief Modifies the visibility of a circular area around a given center-point in the cell.
+	 * @brief Modifies the visibility of the tiles visible from a given center-point within a circular radius, walls block line of sight. \n
+	 * Each span of the field of view is applied to the known-plane as a word-parallel run.
 	 * @param to		- ( true = visible ) ( false = invisible )
 	 * @param pos		- The center-point
 	 * @param radius	- The distance away from the center-point that will also be discovered.
@@ -208,10 +391,88 @@ public:
 	void modVisCircle( const bool to, const Coord& pos, const int radius ) noexcept
 	{
 		if ( !_vis_all || to )
-			for ( int y = pos._y - radius; y <= pos._y + radius; y++ )
-				for ( int x = pos._x - radius; x <= pos._x + radius; x++ )
-					if ( checkDistance::get( x, y, pos, radius ) )
-						modVis( to, x, y );
+			for ( const auto& span : getFOV( pos, radius ) )
+				modVisRow( to, span._y, span._x0, span._x1 );
+	}
+
+	/**
+	 * getFOV(Coord&, int)
+	 * @brief Returns the tiles visible from a given point within a circular radius, walls block line of sight. Results are cached by the field of view calculator.
+	 * @param pos			- The point to calculate the field of view from.
+	 * @param radius		- The maximum distance that can be seen.
+	 * @returns SpanList&	- The visible tiles. This reference is only valid until the next call to getFOV().
+	 */
+	const SpanList& getFOV( const Coord& pos, const int radius ) { return _fov.get( _wall, _wall_version, pos, radius ); }
+
+	/**
+	 * canSee(Coord&, Coord&, int)
+	 * @brief Checks if a tile is visible from another tile, within a circular radius. \n
+	 * This is symmetrical between floor tiles, swapping the two positions gives the same result. Walls are always visible when any part of them is in view, so it isn't symmetrical when one of the positions is a wall.
+	 * @param from		- The viewer's position.
+	 * @param to		- The target position.
+	 * @param radius	- The maximum distance that can be seen.
+	 * @returns bool
+	 */
+	[[nodiscard]] bool canSee( const Coord& from, const Coord& to, const int radius )
+	{
+		return checkDistance::get( to, from, radius ) && spanListContains( getFOV( from, radius ), to._x, to._y );
+	}
+
+	/**
+	 * canSee(Coord&, Coord&, int, FieldOfView&)
+	 * @brief Checks if a tile is visible from another tile, using a separate field of view calculator instead of the cell's own cache. \n
+	 * This doesn't modify the cell, so it can be called from several threads at once as long as each thread uses its own calculator.
+	 * @param from		- The viewer's position.
+	 * @param to		- The target position.
+	 * @param radius	- The maximum distance that can be seen.
+	 * @param fov		- The field of view calculator to use.
+	 * @returns bool
+	 */
+	[[nodiscard]] bool canSee( const Coord& from, const Coord& to, const int radius, FieldOfView& fov ) const
+	{
+		return checkDistance::get( to, from, radius ) && spanListContains( fov.get( _wall, _wall_version, from, radius ), to._x, to._y );
+	}
+
+	/**
+	 * getMovePlane()
+	 * @brief Returns the canMove plane, for algorithms that process the whole cell such as pathfinding.
+	 * @returns BitPlane&
+	 */
+	[[nodiscard]] const BitPlane& getMovePlane() const noexcept { return _can_move; }
+
+	/**
+	 * moveVersion()
+	 * @brief Returns a counter that changes whenever the canMove plane is modified.
+	 * @returns unsigned
+	 */
+	[[nodiscard]] unsigned moveVersion() const noexcept { return _move_version; }
+
+	/**
+	 * modVisDelta(SpanList&, SpanList&, bool, vector<Coord>&)
+	 * @brief Moves the player's revealed area from one set of tiles to another, only touching tiles that are in one set but not the other.
+	 * @param prev		- The previously revealed area.
+	 * @param next		- The newly revealed area.
+	 * @param hidePrev	- When true, tiles that are in prev but not next are hidden again, as if modVis(false) was called on them.
+	 * @param changed	- Receives the position of each tile whose visibility changed. Existing elements are kept.
+	 */
+	void modVisDelta( const SpanList& prev, const SpanList& next, const bool hidePrev, std::vector<Coord>& changed )
+	{
+		forEachDifference( next, prev, [this, &changed]( const long y, const long x0, const long x1 ) {
+			for ( auto x{ x0 }; x <= x1; ++x )
+				if ( !_known.get( x, y ) ) {
+					_known.set( x, y, true );
+					changed.emplace_back( x, y );
+				}
+		} );
+		if ( hidePrev && !_vis_all )
+			forEachDifference( prev, next, [this, &changed]( const long y, const long x0, const long x1 ) {
+				for ( auto x{ x0 }; x <= x1; ++x )
+					if ( _known.get( x, y ) ) {
+						modVisUnchecked( false, x, y );
+						if ( !_known.get( x, y ) )
+							changed.emplace_back( x, y );
+					}
+			} );
 	}
 
 	/**
@@ -224,25 +485,29 @@ public:
 	void modVis( const bool to, const Coord& minPos, const Coord& maxPos ) noexcept
 	{
 		if ( !_vis_all || to )
-			for ( int y = minPos._y; y <= maxPos._y; y++ )
-				for ( int x = minPos._x; x <= maxPos._x; x++ )
-					modVis( to, x, y );
+			for ( auto y{ minPos._y }; y <= maxPos._y; y++ )
+				modVisRow( to, y, minPos._x, maxPos._x );
 	}
 
 	/**
 	 * get(Coord, const bool)
-	 * @brief Returns a pointer to the target tile.
-	 * @param pos		- The target Tiles position.
-	 * @returns Tile*
+	 * @brief Returns a copy of the target tile. Modifying the returned Tile does not modify the cell.
+	 * @param pos				- The target Tiles position.
+	 * @returns optional<Tile>	- std::nullopt if the position is invalid.
 	 */
-	Tile* get( const Coord& pos ) noexcept { return isValidPos( pos ) ? &_matrix.at( pos._y ).at( pos._x ) : nullptr; }
+	std::optional<Tile> get( const Coord& pos ) noexcept { return get( pos._x, pos._y ); }
 
 	/**
 	 * get(Coord, const bool)
-	 * @brief Returns a pointer to the target tile.
-	 * @param x			- The target tile's x index
-	 * @param y			- The target tile's y index
-	 * @returns Tile*
+	 * @brief Returns a copy of the target tile. Modifying the returned Tile does not modify the cell.
+	 * @param x					- The target tile's x index
+	 * @param y					- The target tile's y index
+	 * @returns optional<Tile>	- std::nullopt if the position is invalid.
 	 */
-	Tile* get( const int x, const int y ) noexcept { return isValidPos( x, y ) ? &_matrix.at( y ).at( x ) : nullptr; }
+	std::optional<Tile> get( const int x, const int y ) noexcept
+	{
+		if ( isValidPos( x, y ) )
+			return Tile{ _display[index( x, y )], _known.get( x, y ) };
+		return std::nullopt;
+	}
 };
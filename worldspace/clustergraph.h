@@ -0,0 +1,371 @@
+/**
+ * @file clustergraph.h
+ * @author radj307
+ * @brief Contains the ClusterGraph class, a hierarchical pathfinding graph that divides a cell into square clusters connected by entrances.
+ */
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "bitplane.h"
+
+/**
+ * @class ClusterGraph
+ * @brief Abstract graph used to find paths across large cells, based on HPA*. \n
+ * The cell is divided into square clusters. Wherever two neighbouring clusters share a run of passable tiles along their border, a single entrance is placed at the middle of the run. \n
+ * The walking distance between every pair of entrances in the same cluster is precomputed, so a search only has to visit entrances instead of tiles. \n
+ * The result is a list of waypoints, which the caller refines into tiles one segment at a time. \n
+ * When a tile's passability changes, only the borders touching it are recalculated, and the distances of the affected clusters are recalculated the next time a search visits them.
+ */
+class ClusterGraph final {
+public:
+	static constexpr long CLUSTER_SIZE{ 16L };										///< @brief The width & height of each cluster, in tiles.
+	static constexpr std::uint32_t MAX_NODES{ 4u * static_cast<std::uint32_t>(( CLUSTER_SIZE + 1L ) / 2L) };	///< @brief The maximum number of entrances in a single cluster, there is at most one per run & a border can't have more than half of its length in runs.
+	static constexpr int UNREACHABLE{ INT_MAX };									///< @brief Distance between entrances that are not connected within their cluster.
+
+private:
+	using Transition = std::pair<Coord, Coord>;			///< @brief An entrance, holds the tile on this cluster's side & the adjacent tile on the neighbouring cluster's side.
+	using Node = std::pair<int, std::uint32_t>;			///< @brief Heap entry, holds the estimated total cost & the id of the node.
+
+	/**
+	 * @struct Cluster
+	 * @brief A single cluster. Each cluster owns the entrances on its east & south borders, the others are owned by its west & north neighbours.
+	 */
+	struct Cluster final {
+		std::vector<Transition> _east;	///< @brief Entrances across the east border.
+		std::vector<Transition> _south;	///< @brief Entrances across the south border.
+		std::vector<Coord> _nodes;		///< @brief Tiles of every entrance on this cluster's side, ordered north, west, east, south.
+		std::vector<int> _dist;			///< @brief Distances between each pair of entrances, in row-major order.
+		bool _dirty{ true };			///< @brief When true, _nodes & _dist must be recalculated before they are used.
+	};
+
+	const BitPlane& _passable;			///< @brief The canMove plane of the attached cell.
+	Coord _size;						///< @brief The size of the attached cell.
+	Coord _count;						///< @brief The number of clusters on each axis.
+	std::vector<Cluster> _clusters;		///< @brief Clusters, in row-major order.
+
+	std::uint32_t _goal_id;				///< @brief Node id used for the goal of a search, one past the last entrance.
+	std::uint32_t _start_id;			///< @brief Parent id of the entrances reached directly from the start of a search.
+	unsigned _generation{ 0u };			///< @brief The generation of the current search.
+	std::vector<unsigned> _seen;		///< @brief The generation that each node was last reached in.
+	std::vector<unsigned> _closed;		///< @brief The generation that each node was last expanded in.
+	std::vector<int> _cost;				///< @brief The cost of the shortest known path from the start to each node.
+	std::vector<std::uint32_t> _parent;	///< @brief The previous node on the shortest known path to each node.
+	std::vector<Node> _heap;			///< @brief The open list, a binary min-heap.
+	std::vector<int> _local;			///< @brief Scratch buffer holding the distance to each tile of a cluster, used by flood().
+	std::vector<std::uint32_t> _queue;	///< @brief Scratch buffer used as the breadth-first search queue by flood().
+	std::vector<int> _goal_dist;		///< @brief The distance from each entrance of the goal's cluster to the goal.
+
+	/**
+	 * at(long, long)
+	 * @brief Returns the cluster at a given cluster position. Does not check boundaries.
+	 * @param cx	- X-axis index of the cluster.
+	 * @param cy	- Y-axis index of the cluster.
+	 * @returns Cluster&
+	 */
+	[[nodiscard]] Cluster& at(const long cx, const long cy) noexcept { return _clusters[static_cast<size_t>(cy * _count._x + cx)]; }
+
+	/**
+	 * clusterOf(Coord&)
+	 * @brief Returns the index of the cluster containing a given tile.
+	 * @param pos	- Target position
+	 * @returns uint32_t
+	 */
+	[[nodiscard]] std::uint32_t clusterOf(const Coord& pos) const noexcept { return static_cast<std::uint32_t>(pos._y / CLUSTER_SIZE * _count._x + pos._x / CLUSTER_SIZE); }
+
+	/**
+	 * build_border(Coord&, Coord&, long, vector<Transition>&)
+	 * @brief Finds the entrances along one border, placing one at the middle of every run of tiles that are passable on both sides.
+	 * @param first	- The first tile on the near side of the border.
+	 * @param step	- The offset to the far side of the border, either (1, 0) or (0, 1).
+	 * @param length	- The length of the border.
+	 * @param out	- Receives the entrances. This is cleared first.
+	 */
+	void build_border(const Coord& first, const Coord& step, const long length, std::vector<Transition>& out)
+	{
+		out.clear();
+		const Coord along{ step._y, step._x }; // perpendicular to step
+		const auto open{ [&](const long i) {
+			const auto x{ first._x + along._x * i }, y{ first._y + along._y * i };
+			return _passable.get(x, y) && _passable.get(x + step._x, y + step._y);
+		} };
+		for ( long i{ 0L }; i < length; ++i ) {
+			if ( !open(i) )
+				continue;
+			const auto begin{ i };
+			while ( i + 1 < length && open(i + 1) )
+				++i;
+			const auto mid{ ( begin + i ) / 2 };
+			const Coord inside{ first._x + along._x * mid, first._y + along._y * mid };
+			out.emplace_back(inside, Coord{ inside._x + step._x, inside._y + step._y });
+		}
+	}
+
+	/**
+	 * build_borders(long, long)
+	 * @brief Recalculates the entrances on the east & south borders of a cluster.
+	 * @param cx	- X-axis index of the cluster.
+	 * @param cy	- Y-axis index of the cluster.
+	 */
+	void build_borders(const long cx, const long cy)
+	{
+		auto& c{ at(cx, cy) };
+		const auto x1{ ( cx + 1 ) * CLUSTER_SIZE < _size._x ? ( cx + 1 ) * CLUSTER_SIZE : _size._x };
+		const auto y1{ ( cy + 1 ) * CLUSTER_SIZE < _size._y ? ( cy + 1 ) * CLUSTER_SIZE : _size._y };
+		if ( cx + 1 < _count._x )
+			build_border({ x1 - 1, cy * CLUSTER_SIZE }, { 1, 0 }, y1 - cy * CLUSTER_SIZE, c._east);
+		else c._east.clear();
+		if ( cy + 1 < _count._y )
+			build_border({ cx * CLUSTER_SIZE, y1 - 1 }, { 0, 1 }, x1 - cx * CLUSTER_SIZE, c._south);
+		else c._south.clear();
+	}
+
+	/**
+	 * northCount(long, long)
+	 * @brief Returns the number of entrances on a cluster's north border, which are owned by its north neighbour.
+	 */
+	[[nodiscard]] std::uint32_t northCount(const long cx, const long cy) noexcept { return cy > 0 ? static_cast<std::uint32_t>(at(cx, cy - 1)._south.size()) : 0u; }
+	/**
+	 * westCount(long, long)
+	 * @brief Returns the number of entrances on a cluster's west border, which are owned by its west neighbour.
+	 */
+	[[nodiscard]] std::uint32_t westCount(const long cx, const long cy) noexcept { return cx > 0 ? static_cast<std::uint32_t>(at(cx - 1, cy)._east.size()) : 0u; }
+
+	/**
+	 * partner(uint32_t)
+	 * @brief Returns the id of the entrance on the other side of the border from a given entrance. \n
+	 * This is calculated from the border lists, so it is always up to date even if either cluster is dirty.
+	 * @param id		- Node id of the entrance.
+	 * @returns uint32_t
+	 */
+	[[nodiscard]] std::uint32_t partner(const std::uint32_t id) noexcept
+	{
+		const auto c{ id / MAX_NODES };
+		auto l{ id % MAX_NODES };
+		const auto cx{ static_cast<long>(c % static_cast<std::uint32_t>(_count._x)) }, cy{ static_cast<long>(c / static_cast<std::uint32_t>(_count._x)) };
+		const auto toId{ [this](const long x, const long y, const std::uint32_t local) { return static_cast<std::uint32_t>(y * _count._x + x) * MAX_NODES + local; } };
+		if ( const auto n{ northCount(cx, cy) }; l < n ) // owned by the north neighbour, where it is in the south list
+			return toId(cx, cy - 1, northCount(cx, cy - 1) + westCount(cx, cy - 1) + static_cast<std::uint32_t>(at(cx, cy - 1)._east.size()) + l);
+		else l -= n;
+		if ( const auto n{ westCount(cx, cy) }; l < n ) // owned by the west neighbour, where it is in the east list
+			return toId(cx - 1, cy, northCount(cx - 1, cy) + westCount(cx - 1, cy) + l);
+		else l -= n;
+		if ( const auto n{ static_cast<std::uint32_t>(at(cx, cy)._east.size()) }; l < n ) // in the east neighbour's west list
+			return toId(cx + 1, cy, northCount(cx + 1, cy) + l);
+		else l -= n;
+		return toId(cx, cy + 1, l); // in the south neighbour's north list
+	}
+
+	/**
+	 * flood(uint32_t, Coord&, Coord&)
+	 * @brief Calculates the walking distance from a tile to every other tile in the same cluster, without leaving the cluster. The results are stored in _local.
+	 * @param c		- Index of the cluster.
+	 * @param origin	- The tile to start from, this is always included even if it isn't passable.
+	 * @param extra	- A tile that is treated as passable, such as a goal occupied by an actor.
+	 */
+	void flood(const std::uint32_t c, const Coord& origin, const Coord& extra)
+	{
+		const auto x0{ static_cast<long>(c % static_cast<std::uint32_t>(_count._x)) * CLUSTER_SIZE }, y0{ static_cast<long>(c / static_cast<std::uint32_t>(_count._x)) * CLUSTER_SIZE };
+		const auto w{ x0 + CLUSTER_SIZE < _size._x ? CLUSTER_SIZE : _size._x - x0 }, h{ y0 + CLUSTER_SIZE < _size._y ? CLUSTER_SIZE : _size._y - y0 };
+		std::fill(_local.begin(), _local.end(), UNREACHABLE);
+		_queue.clear();
+		const auto start{ static_cast<std::uint32_t>(( origin._y - y0 ) * CLUSTER_SIZE + origin._x - x0) };
+		_local[start] = 0;
+		_queue.push_back(start);
+		for ( size_t head{ 0u }; head < _queue.size(); ++head ) {
+			const auto i{ _queue[head] };
+			const auto lx{ static_cast<long>(i % CLUSTER_SIZE) }, ly{ static_cast<long>(i / CLUSTER_SIZE) };
+			const auto visit{ [&, i](const long nx, const long ny) {
+				if ( nx < 0 || ny < 0 || nx >= w || ny >= h )
+					return;
+				const auto n{ static_cast<std::uint32_t>(ny * CLUSTER_SIZE + nx) };
+				if ( _local[n] == UNREACHABLE && ( _passable.get(x0 + nx, y0 + ny) || Coord{ x0 + nx, y0 + ny } == extra ) ) {
+					_local[n] = _local[i] + 1;
+					_queue.push_back(n);
+				}
+			} };
+			visit(lx, ly - 1);
+			visit(lx, ly + 1);
+			visit(lx - 1, ly);
+			visit(lx + 1, ly);
+		}
+	}
+
+	/**
+	 * local(uint32_t, Coord&)
+	 * @brief Returns the distance to a tile from the last call to flood().
+	 * @param c		- Index of the cluster that was flooded.
+	 * @param pos	- A tile within that cluster.
+	 * @returns int
+	 */
+	[[nodiscard]] int local(const std::uint32_t c, const Coord& pos) const noexcept
+	{
+		const auto x0{ static_cast<long>(c % static_cast<std::uint32_t>(_count._x)) * CLUSTER_SIZE }, y0{ static_cast<long>(c / static_cast<std::uint32_t>(_count._x)) * CLUSTER_SIZE };
+		return _local[static_cast<size_t>(( pos._y - y0 ) * CLUSTER_SIZE + pos._x - x0)];
+	}
+
+	/**
+	 * ensure(uint32_t)
+	 * @brief Recalculates the entrances & distances of a cluster, if it is dirty.
+	 * @param c		- Index of the cluster.
+	 * @returns Cluster&
+	 */
+	Cluster& ensure(const std::uint32_t c)
+	{
+		auto& cluster{ _clusters[c] };
+		if ( !cluster._dirty )
+			return cluster;
+		const auto cx{ static_cast<long>(c % static_cast<std::uint32_t>(_count._x)) }, cy{ static_cast<long>(c / static_cast<std::uint32_t>(_count._x)) };
+		cluster._nodes.clear();
+		if ( cy > 0 )
+			for ( const auto& [inside, outside] : at(cx, cy - 1)._south )
+				cluster._nodes.push_back(outside);
+		if ( cx > 0 )
+			for ( const auto& [inside, outside] : at(cx - 1, cy)._east )
+				cluster._nodes.push_back(outside);
+		for ( const auto& [inside, outside] : cluster._east )
+			cluster._nodes.push_back(inside);
+		for ( const auto& [inside, outside] : cluster._south )
+			cluster._nodes.push_back(inside);
+		const auto n{ cluster._nodes.size() };
+		cluster._dist.assign(n * n, UNREACHABLE);
+		for ( size_t i{ 0u }; i < n; ++i ) {
+			flood(c, cluster._nodes[i], cluster._nodes[i]);
+			for ( size_t j{ 0u }; j < n; ++j )
+				cluster._dist[i * n + j] = local(c, cluster._nodes[j]);
+		}
+		cluster._dirty = false;
+		return cluster;
+	}
+
+	/**
+	 * next_generation()
+	 * @brief Begins a new search by incrementing the generation, only clearing the node stamps when the counter wraps around.
+	 */
+	void next_generation()
+	{
+		if ( ++_generation == 0u ) {
+			std::fill(_seen.begin(), _seen.end(), 0u);
+			std::fill(_closed.begin(), _closed.end(), 0u);
+			_generation = 1u;
+		}
+		_heap.clear();
+	}
+
+public:
+	/**
+	 * ClusterGraph(BitPlane&)
+	 * @brief Create a cluster graph for a cell, and find the entrances of every cluster. Distances are calculated when a cluster is first searched.
+	 * @param passable	- The canMove plane of the cell, this must outlive the graph.
+	 */
+	explicit ClusterGraph(const BitPlane& passable) :
+		_passable(passable), _size(passable.width(), passable.height()),
+		_count(( _size._x + CLUSTER_SIZE - 1 ) / CLUSTER_SIZE, ( _size._y + CLUSTER_SIZE - 1 ) / CLUSTER_SIZE),
+		_clusters(static_cast<size_t>(_count._x * _count._y)),
+		_goal_id(static_cast<std::uint32_t>(_clusters.size()) * MAX_NODES), _start_id(_goal_id + 1u),
+		_seen(static_cast<size_t>(_goal_id) + 1u, 0u), _closed(_seen.size(), 0u), _cost(_seen.size(), 0), _parent(_seen.size(), 0u),
+		_local(static_cast<size_t>(CLUSTER_SIZE * CLUSTER_SIZE), UNREACHABLE), _goal_dist(MAX_NODES, UNREACHABLE)
+	{
+		for ( long cy{ 0L }; cy < _count._y; ++cy )
+			for ( long cx{ 0L }; cx < _count._x; ++cx )
+				build_borders(cx, cy);
+	}
+
+	/**
+	 * invalidate(Coord&)
+	 * @brief Updates the graph after the passability of a tile changed. \n
+	 * The borders touching the tile's cluster are recalculated immediately, and the cluster & its neighbours are recalculated the next time a search visits them.
+	 * @param pos	- The tile that changed.
+	 */
+	void invalidate(const Coord& pos)
+	{
+		if ( pos._x < 0 || pos._y < 0 || pos._x >= _size._x || pos._y >= _size._y )
+			return;
+		const auto cx{ pos._x / CLUSTER_SIZE }, cy{ pos._y / CLUSTER_SIZE };
+		build_borders(cx, cy);
+		if ( cx > 0 ) build_borders(cx - 1, cy);
+		if ( cy > 0 ) build_borders(cx, cy - 1);
+		// the entrances of the cluster & all of its neighbours may have changed
+		at(cx, cy)._dirty = true;
+		if ( cx > 0 ) at(cx - 1, cy)._dirty = true;
+		if ( cy > 0 ) at(cx, cy - 1)._dirty = true;
+		if ( cx + 1 < _count._x ) at(cx + 1, cy)._dirty = true;
+		if ( cy + 1 < _count._y ) at(cx, cy + 1)._dirty = true;
+	}
+
+	/**
+	 * find(Coord&, Coord&, vector<Coord>&)
+	 * @brief Searches the abstract graph for a route between two tiles.
+	 * @param from		- The starting position.
+	 * @param to		- The goal position. This tile doesn't have to be passable, as it is usually occupied by the target.
+	 * @param out		- Receives the waypoints, in reverse order so that the first waypoint is at the back. The goal is always the last waypoint. This is cleared first.
+	 * @returns bool	- ( true = A route was found ) ( false = The goal is unreachable )
+	 */
+	bool find(const Coord& from, const Coord& to, std::vector<Coord>& out)
+	{
+		out.clear();
+		const auto inBounds{ [this](const Coord& p) { return p._x >= 0 && p._y >= 0 && p._x < _size._x && p._y < _size._y; } };
+		if ( !inBounds(from) || !inBounds(to) || from == to )
+			return false;
+		next_generation();
+		const auto heuristic{ [&to](const Coord& p) { return static_cast<int>(( p._x < to._x ? to._x - p._x : p._x - to._x ) + ( p._y < to._y ? to._y - p._y : p._y - to._y )); } };
+		const auto relax{ [this](const std::uint32_t id, const int cost, const int estimate, const std::uint32_t parent) {
+			if ( _closed[id] != _generation && ( _seen[id] != _generation || cost < _cost[id] ) ) {
+				_seen[id] = _generation;
+				_cost[id] = cost;
+				_parent[id] = parent;
+				_heap.emplace_back(cost + estimate, id);
+				std::push_heap(_heap.begin(), _heap.end(), std::greater<>{});
+			}
+		} };
+
+		// distances from the goal to the entrances of its cluster
+		const auto gc{ clusterOf(to) };
+		const auto& goalCluster{ ensure(gc) };
+		flood(gc, to, to);
+		for ( size_t j{ 0u }; j < goalCluster._nodes.size(); ++j )
+			_goal_dist[j] = local(gc, goalCluster._nodes[j]);
+
+		// distances from the start to the entrances of its cluster
+		const auto sc{ clusterOf(from) };
+		const auto& startCluster{ ensure(sc) };
+		flood(sc, from, to);
+		if ( sc == gc && local(sc, to) != UNREACHABLE )
+			relax(_goal_id, local(sc, to), 0, _start_id);
+		for ( size_t j{ 0u }; j < startCluster._nodes.size(); ++j )
+			if ( const auto d{ local(sc, startCluster._nodes[j]) }; d != UNREACHABLE )
+				relax(sc * MAX_NODES + static_cast<std::uint32_t>(j), d, heuristic(startCluster._nodes[j]), _start_id);
+
+		while ( !_heap.empty() ) {
+			std::pop_heap(_heap.begin(), _heap.end(), std::greater<>{});
+			const auto id{ _heap.back().second };
+			_heap.pop_back();
+			if ( _closed[id] == _generation )
+				continue; // stale entry
+			_closed[id] = _generation;
+			if ( id == _goal_id ) { // walk back along the parents to build the waypoint list
+				out.push_back(to);
+				for ( auto n{ _parent[id] }; n != _start_id; n = _parent[n] )
+					out.push_back(_clusters[n / MAX_NODES]._nodes[n % MAX_NODES]);
+				return true;
+			}
+			const auto c{ id / MAX_NODES }, l{ id % MAX_NODES };
+			const auto& cluster{ ensure(c) };
+			const auto n{ cluster._nodes.size() };
+			if ( c == gc && _goal_dist[l] != UNREACHABLE )
+				relax(_goal_id, _cost[id] + _goal_dist[l], 0, id);
+			// cross the border to the neighbouring cluster
+			const auto p{ partner(id) };
+			relax(p, _cost[id] + 1, heuristic(ensure(p / MAX_NODES)._nodes[p % MAX_NODES]), id);
+			// move to another entrance of this cluster
+			for ( size_t j{ 0u }; j < n; ++j )
+				if ( const auto d{ cluster._dist[l * n + j] }; j != l && d != UNREACHABLE )
+					relax(c * MAX_NODES + static_cast<std::uint32_t>(j), _cost[id] + d, heuristic(cluster._nodes[j]), id);
+		}
+		return false;
+	}
+};
@@ -0,0 +1,173 @@
+/**
+ * @file flowfield.h
+ * @author radj307
+ * @brief Contains the FlowField class, a distance map from a single point that any number of actors can follow towards, or away from, that point.
+ */
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <vector>
+
+#include "bitplane.h"
+
+/**
+ * @class FlowField
+ * @brief Stores the walking distance from every passable tile to a source tile, calculated with a breadth-first search. \n
+ * Actors pursuing the source step to the neighbouring tile with the lowest distance, so every actor can find its next step in constant time. \n
+ * A companion flee field is also provided, which is the distance field scaled by a negative factor & re-relaxed, so fleeing actors route around obstacles towards open space instead of into corners. \n
+ * Values are scaled by STEP, so that the flee factor can be represented with integers.
+ */
+class FlowField final {
+public:
+	static constexpr int STEP{ 10 };				///< @brief The cost of a single step between two adjacent tiles.
+	static constexpr int FLEE_FACTOR{ -12 };		///< @brief Multiplier (divided by STEP) applied to the distance field to create the flee field. Must be less than -STEP.
+	static constexpr int UNREACHABLE{ INT_MAX };	///< @brief Value of tiles that can't be reached from the source.
+
+private:
+	Coord _size;						///< @brief The size of the field, this should match the size of the attached Cell.
+	Coord _source{};					///< @brief The source tile that the distance field was last calculated from.
+	unsigned _version{ 0u };			///< @brief The move version of the cell when the distance field was last calculated.
+	bool _valid{ false };				///< @brief When true, the distance field matches _source & _version.
+	bool _flee_valid{ false };			///< @brief When true, the flee field matches the distance field.
+	std::vector<int> _dist;				///< @brief Distance field, in row-major order.
+	std::vector<int> _flee;				///< @brief Flee field, in row-major order.
+	std::vector<size_t> _queue;			///< @brief Scratch buffer used as the breadth-first search queue.
+	std::vector<std::pair<int, size_t>> _heap; ///< @brief Scratch buffer used as the flee field's priority queue, a min-heap.
+
+	/**
+	 * index(long, long)
+	 * @brief Returns the row-major index of a given position. Does not check boundaries.
+	 * @param x		- X-axis (horizontal) index.
+	 * @param y		- Y-axis (vertical) index.
+	 * @returns size_t
+	 */
+	[[nodiscard]] size_t index( const long x, const long y ) const noexcept { return static_cast<size_t>(y) * static_cast<size_t>(_size._x) + static_cast<size_t>(x); }
+
+	/**
+	 * forEachNeighbour(size_t, Func&&)
+	 * @brief Calls a function with the index of each tile orthogonally adjacent to a given tile, that is within the field.
+	 * @param i		- Index of the center tile.
+	 * @param func	- Function with the signature void(size_t)
+	 */
+	template<typename Func>
+	void forEachNeighbour( const size_t i, Func&& func ) const
+	{
+		const auto x{ static_cast<long>(i % static_cast<size_t>(_size._x)) }, y{ static_cast<long>(i / static_cast<size_t>(_size._x)) };
+		if ( y > 0 )				func( i - static_cast<size_t>(_size._x) );
+		if ( y + 1 < _size._y )		func( i + static_cast<size_t>(_size._x) );
+		if ( x > 0 )				func( i - 1u );
+		if ( x + 1 < _size._x )		func( i + 1u );
+	}
+
+	/**
+	 * build(BitPlane&)
+	 * @brief Calculates the distance field from _source with a breadth-first search.
+	 * @param passable	- The canMove plane of the cell.
+	 */
+	void build( const BitPlane& passable )
+	{
+		std::fill( _dist.begin(), _dist.end(), UNREACHABLE );
+		_queue.clear();
+		if ( _source._x < 0 || _source._y < 0 || _source._x >= _size._x || _source._y >= _size._y )
+			return;
+		// the source tile is always the root, even if it isn't passable
+		_dist[index( _source._x, _source._y )] = 0;
+		_queue.push_back( index( _source._x, _source._y ) );
+		for ( size_t head{ 0u }; head < _queue.size(); ++head ) {
+			const auto i{ _queue[head] };
+			forEachNeighbour( i, [this, &passable, i]( const size_t n ) {
+				const auto x{ static_cast<long>(n % static_cast<size_t>(_size._x)) }, y{ static_cast<long>(n / static_cast<size_t>(_size._x)) };
+				if ( _dist[n] == UNREACHABLE && passable.get( x, y ) ) {
+					_dist[n] = _dist[i] + STEP;
+					_queue.push_back( n );
+				}
+			} );
+		}
+	}
+
+	/**
+	 * buildFlee()
+	 * @brief Calculates the flee field from the distance field, with Dijkstra's algorithm seeded by the scaled distance of every reachable tile.
+	 */
+	void buildFlee()
+	{
+		_heap.clear();
+		for ( size_t i{ 0u }; i < _dist.size(); ++i ) {
+			_flee[i] = _dist[i] == UNREACHABLE ? UNREACHABLE : _dist[i] / STEP * FLEE_FACTOR;
+			if ( _flee[i] != UNREACHABLE )
+				_heap.emplace_back( _flee[i], i );
+		}
+		std::make_heap( _heap.begin(), _heap.end(), std::greater<>{} );
+		while ( !_heap.empty() ) {
+			std::pop_heap( _heap.begin(), _heap.end(), std::greater<>{} );
+			const auto [value, i] { _heap.back() };
+			_heap.pop_back();
+			if ( value != _flee[i] )
+				continue; // stale entry
+			forEachNeighbour( i, [this, value]( const size_t n ) {
+				// only tiles that were reachable in the distance field are part of the flee field
+				if ( _flee[n] != UNREACHABLE && value + STEP < _flee[n] ) {
+					_flee[n] = value + STEP;
+					_heap.emplace_back( _flee[n], n );
+					std::push_heap( _heap.begin(), _heap.end(), std::greater<>{} );
+				}
+			} );
+		}
+		_flee_valid = true;
+	}
+
+public:
+	/**
+	 * FlowField(Coord&)
+	 * @brief Create an empty flow field of the given size.
+	 * @param size	- The size of the field, this should be the _max member of the attached Cell.
+	 */
+	explicit FlowField( const Coord& size ) : _size( size ), _dist( static_cast<size_t>(size._x > 0 ? size._x : 0) * static_cast<size_t>(size._y > 0 ? size._y : 0), UNREACHABLE ), _flee( _dist.size(), UNREACHABLE ) {}
+
+	/**
+	 * update(BitPlane&, unsigned, Coord&)
+	 * @brief Recalculates the distance field if the source tile or the cell's passability changed since the last call.
+	 * @param passable	- The canMove plane of the cell.
+	 * @param version	- The cell's current move version.
+	 * @param source	- The tile that actors should move towards, such as the player's position.
+	 */
+	void update( const BitPlane& passable, const unsigned version, const Coord& source )
+	{
+		if ( !_valid || version != _version || !( source == _source ) ) {
+			_source = source;
+			_version = version;
+			build( passable );
+			_valid = true;
+			_flee_valid = false; // the flee field is only recalculated when it is needed
+		}
+	}
+
+	/**
+	 * getSteps(Coord&, bool, Coord(&)[4])
+	 * @brief Retrieves the neighbouring tiles that move an actor closer to (or away from) the source, best first.
+	 * @param from		- The actor's current position.
+	 * @param flee		- When true, the flee field is used instead of the distance field.
+	 * @param out		- Receives up to 4 positions, sorted from best to worst. Only tiles that improve on the current tile are included.
+	 * @returns size_t	- The number of positions written to out.
+	 */
+	size_t getSteps( const Coord& from, const bool flee, Coord( &out )[4] )
+	{
+		if ( !_valid || from._x < 0 || from._y < 0 || from._x >= _size._x || from._y >= _size._y )
+			return 0u;
+		if ( flee && !_flee_valid )
+			buildFlee();
+		const auto& field{ flee ? _flee : _dist };
+		const auto here{ field[index( from._x, from._y )] };
+		size_t count{ 0u };
+		forEachNeighbour( index( from._x, from._y ), [this, &field, &out, &count, here]( const size_t n ) {
+			if ( field[n] < here ) { // insertion sort, there are at most 4 elements
+				auto j{ count++ };
+				for ( ; j > 0u && field[index( out[j - 1u]._x, out[j - 1u]._y )] > field[n]; --j )
+					out[j] = out[j - 1u];
+				out[j] = { static_cast<long>(n % static_cast<size_t>(_size._x)), static_cast<long>(n / static_cast<size_t>(_size._x)) };
+			}
+		} );
+		return count;
+	}
+};
@@ -0,0 +1,207 @@
+/**
+ * @file fov.h
+ * @author radj307
+ * @brief Contains the FieldOfView class, which calculates the tiles visible from a given point using symmetric shadowcasting.
+ */
+#pragma once
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "bitplane.h"
+#include "span.h"
+
+/**
+ * @class FieldOfView
+ * @brief Calculates which tiles are visible from a point, within a circular radius, with walls blocking line of sight. \n
+ * Uses symmetric shadowcasting, so if floor tile A can see floor tile B, then tile B can also see tile A. \n
+ * Walls are revealed whenever any part of them is in view so that room outlines are drawn, which means a wall can be visible from a tile that it couldn't see itself. \n
+ * Results are returned as a SpanList, and the most recently used results are cached by origin, radius, & wall version.
+ */
+class FieldOfView final {
+	/**
+	 * @struct Key
+	 * @brief Identifies a single cached result.
+	 */
+	struct Key final {
+		long _x, _y;
+		int _radius;
+		unsigned _version;
+
+		bool operator==( const Key& o ) const { return _x == o._x && _y == o._y && _radius == o._radius && _version == o._version; }
+	};
+	/**
+	 * @struct KeyHash
+	 * @brief Hash functor for the Key struct.
+	 */
+	struct KeyHash final {
+		size_t operator()( const Key& k ) const noexcept
+		{
+			auto h{ static_cast<size_t>(k._x) * 0x9E3779B97F4A7C15ull };
+			h ^= static_cast<size_t>(k._y) + 0x7F4A7C15ull + ( h << 6 ) + ( h >> 2 );
+			h ^= static_cast<size_t>(k._radius) + ( h << 6 ) + ( h >> 2 );
+			h ^= static_cast<size_t>(k._version) + ( h << 6 ) + ( h >> 2 );
+			return h;
+		}
+	};
+	using Entry = std::pair<Key, SpanList>;
+
+	/**
+	 * @struct Row
+	 * @brief A single row of a quadrant being scanned. The start & end slopes are stored as fractions with a positive denominator.
+	 */
+	struct Row final {
+		long _depth;
+		long _start_num, _start_den;
+		long _end_num, _end_den;
+	};
+
+	size_t _capacity;			///< @brief The maximum number of cached results.
+	std::list<Entry> _lru;		///< @brief Cached results, ordered from most to least recently used.
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _index; ///< @brief Lookup table for the _lru list.
+	std::vector<char> _visible;	///< @brief Scratch buffer used by compute(), one element per tile in the square around the origin.
+	std::vector<Row> _stack;	///< @brief Scratch buffer used by compute(), holds rows that still need to be scanned.
+
+	/**
+	 * floorDiv(long, long)
+	 * @brief Integer division that rounds towards negative infinity. The denominator must be positive.
+	 */
+	static long floorDiv( const long num, const long den ) noexcept { return num >= 0 ? num / den : -( ( -num + den - 1 ) / den ); }
+	/**
+	 * ceilDiv(long, long)
+	 * @brief Integer division that rounds towards positive infinity. The denominator must be positive.
+	 */
+	static long ceilDiv( const long num, const long den ) noexcept { return -floorDiv( -num, den ); }
+
+	/**
+	 * compute(BitPlane&, Coord&, int, SpanList&)
+	 * @brief Calculates the field of view from a given point.
+	 * @param walls		- Wall plane of the cell, tiles outside of the plane are treated as walls.
+	 * @param origin	- The point to calculate the field of view from.
+	 * @param radius	- The maximum distance that can be seen, using the same inclusion test as checkDistance::get().
+	 * @param out		- Receives the visible tiles, clipped to the plane's boundaries. This is cleared first.
+	 */
+	void compute( const BitPlane& walls, const Coord& origin, const int radius, SpanList& out )
+	{
+		out.clear();
+		if ( radius < 0 || origin._x < 0 || origin._y < 0 || origin._x >= walls.width() || origin._y >= walls.height() )
+			return;
+		const long side{ radius * 2L + 1L };
+		_visible.assign( static_cast<size_t>(side * side), 0 );
+		const auto isWall{ [&walls]( const long x, const long y ) { return x < 0 || y < 0 || x >= walls.width() || y >= walls.height() || walls.get( x, y ); } };
+		const auto reveal{ [this, &walls, &origin, radius, side]( const long x, const long y ) {
+			const auto dx{ x - origin._x }, dy{ y - origin._y };
+			if ( x >= 0 && y >= 0 && x < walls.width() && y < walls.height() && dx * dx + dy * dy <= static_cast<long>(radius) * radius )
+				_visible[static_cast<size_t>( ( dy + radius ) * side + dx + radius )] = 1;
+		} };
+		reveal( origin._x, origin._y );
+
+		for ( auto quadrant{ 0 }; quadrant < 4; ++quadrant ) {
+			// transforms a (depth, column) pair in this quadrant to a position in the cell
+			const auto transform{ [&origin, quadrant]( const long depth, const long col ) -> Coord {
+				switch ( quadrant ) {
+				case 0: return { origin._x + col, origin._y - depth };	// north
+				case 1: return { origin._x + col, origin._y + depth };	// south
+				case 2: return { origin._x + depth, origin._y + col };	// east
+				default: return { origin._x - depth, origin._y + col };	// west
+				}
+			} };
+			_stack.clear();
+			_stack.push_back( { 1, -1, 1, 1, 1 } );
+			while ( !_stack.empty() ) {
+				auto row{ _stack.back() };
+				_stack.pop_back();
+				if ( row._depth > radius )
+					continue;
+				// round_ties_up(depth * start) & round_ties_down(depth * end)
+				const auto minCol{ floorDiv( 2 * row._depth * row._start_num + row._start_den, 2 * row._start_den ) };
+				const auto maxCol{ ceilDiv( 2 * row._depth * row._end_num - row._end_den, 2 * row._end_den ) };
+				auto prevWall{ -1 }; // -1 means there is no previous tile in this row
+				for ( auto col{ minCol }; col <= maxCol; ++col ) {
+					const auto pos{ transform( row._depth, col ) };
+					const auto wall{ isWall( pos._x, pos._y ) };
+					// walls are always revealed, floor tiles only when they are symmetric (their center is within the slopes)
+					if ( wall || ( col * row._start_den >= row._depth * row._start_num && col * row._end_den <= row._depth * row._end_num ) )
+						reveal( pos._x, pos._y );
+					if ( prevWall == 1 && !wall ) { // start of a new gap, move the start slope to this tile's left edge
+						row._start_num = 2 * col - 1;
+						row._start_den = 2 * row._depth;
+					}
+					if ( prevWall == 0 && wall ) // end of a gap, scan the next row through it
+						_stack.push_back( { row._depth + 1, row._start_num, row._start_den, 2 * col - 1, 2 * row._depth } );
+					prevWall = wall;
+				}
+				if ( prevWall == 0 )
+					_stack.push_back( { row._depth + 1, row._start_num, row._start_den, row._end_num, row._end_den } );
+			}
+		}
+
+		// convert the visible tiles to spans
+		for ( long dy{ 0 }; dy < side; ++dy ) {
+			const auto* const line{ &_visible[static_cast<size_t>(dy * side)] };
+			for ( long dx{ 0 }; dx < side; ++dx ) {
+				if ( !line[dx] )
+					continue;
+				const auto first{ dx };
+				while ( dx + 1 < side && line[dx + 1] )
+					++dx;
+				out.push_back( { origin._y - radius + dy, origin._x - radius + first, origin._x - radius + dx } );
+			}
+		}
+	}
+
+public:
+	/**
+	 * FieldOfView(size_t)
+	 * @brief Create a field of view calculator with an empty cache.
+	 * @param capacity	- (Default: 512) The maximum number of results to keep in the cache.
+	 */
+	explicit FieldOfView( const size_t capacity = 512u ) : _capacity( capacity > 0u ? capacity : 1u ) {}
+	/**
+	 * FieldOfView(FieldOfView&)
+	 * @brief Copy constructor, the cache is not copied because its index refers to the other instance's storage.
+	 * @param o	- The instance to copy the capacity from.
+	 */
+	FieldOfView( const FieldOfView& o ) : _capacity( o._capacity ) {}
+	FieldOfView( FieldOfView&& ) noexcept = default;
+	FieldOfView& operator=( const FieldOfView& o )
+	{
+		if ( this != &o ) {
+			_capacity = o._capacity;
+			_lru.clear();
+			_index.clear();
+		}
+		return *this;
+	}
+	FieldOfView& operator=( FieldOfView&& ) noexcept = default;
+	~FieldOfView() = default;
+
+	/**
+	 * get(BitPlane&, unsigned, Coord&, int)
+	 * @brief Returns the tiles visible from a given point, calculating them only if a matching result isn't already cached.
+	 * @param walls			- Wall plane of the cell.
+	 * @param version		- The current wall version of the cell, this must change whenever the wall plane is modified.
+	 * @param origin		- The point to calculate the field of view from.
+	 * @param radius		- The maximum distance that can be seen.
+	 * @returns SpanList&	- The visible tiles. This reference is only valid until the next call to get().
+	 */
+	const SpanList& get( const BitPlane& walls, const unsigned version, const Coord& origin, const int radius )
+	{
+		const Key key{ origin._x, origin._y, radius, version };
+		if ( const auto it{ _index.find( key ) }; it != _index.end() ) {
+			_lru.splice( _lru.begin(), _lru, it->second ); // move to the front
+			return it->second->second;
+		}
+		if ( _lru.size() >= _capacity ) { // evict the least recently used result, and reuse its storage
+			_index.erase( _lru.back().first );
+			_lru.splice( _lru.begin(), _lru, std::prev( _lru.end() ) );
+			_lru.front().first = key;
+		}
+		else
+			_lru.emplace_front( key, SpanList{} );
+		_index.emplace( key, _lru.begin() );
+		compute( walls, origin, radius, _lru.front().second );
+		return _lru.front().second;
+	}
+};
@@ -4,11 +4,9 @@
  * @author radj307
  */
 #pragma once
-#include <future>	// for capturing thread return values
 #include <INI.hpp>	// for INI parser
-#include <mutex>	// for mutexes & scoped locks
 #include <sys.h>	// for system commands
-#include <thread>	// for threads
+#include <thread>	// for sleep_for
 
 #include "init.h"
 #include "shared.h"
@@ -67,7 +65,7 @@ namespace game {
 
 	/**
 	 * start(vector<string>&, optional<CONTROLS>, optional<GameRules>)
-	 * @brief Thread Manager. Starts the game threads and returns once the game is over.
+	 * @brief Thread Manager. Starts the job system & game loop, and returns once the game is over.
 	 * @param INI_Files		- String vector containing INI filenames.
 	 * @param controlset	- (Default: nullopt) Optional controlset override, including this will disable loading the controlset from INI.
 	 * @param ruleset		- (Default: nullopt) Optional ruleset override, including this will disable loading the ruleset from INI.
@@ -94,17 +92,16 @@ namespace game {
 		// instantiate shared memory
 		_internal::memory mem;
 
-		// create a mutex to prevent critical section overlap
-		std::mutex mutx;
+		// create the thread pool that runs every game task, this must outlive the gamespace
+		JobSystem jobs;
 
 		// Create gamespace with ruleset
 		Gamespace thisGame(rules);
 		
-		try { // Start the game threads
-			auto // Init asynchronous threads
-				display[[maybe_unused]]{ std::async(std::launch::async, &_internal::thread_display, std::ref(mutx), std::ref(mem), std::ref(thisGame), std::ref(rules)) },
-				enemy[[maybe_unused]]{ std::async(std::launch::async, &_internal::thread_npc, std::ref(mutx), std::ref(mem), std::ref(thisGame)) },
-				player[[maybe_unused]]{ std::async(std::launch::async, &_internal::thread_player, std::ref(mutx), std::ref(mem), std::ref(thisGame)) };
+		try { // Run the game loop on this thread, it returns once the kill flag is set
+			if ( _internal::__HEADLESS )
+				_internal::run_headless(mem, thisGame, rules, jobs, _internal::__HEADLESS_TICKS);
+			else _internal::run(mem, thisGame, rules, jobs);
 		} catch ( std::exception & ex ) {
 			sys::cls();
 			std::cout << sys::error << "An unhandled thread exception occurred, but was caught by the thread manager: \"" << ex.what() << "\"" << std::endl;
@@ -47,6 +47,7 @@ namespace game::_internal {
 					"world", {
 						{ "sizeH",					"30"	 },
 						{ "sizeV",					"30"	 },
+						{ "seed",					"0"		 },
 						{ "showAllTiles",			"false"	 },
 						{ "showAllWalls",			"true"	 },
 						{ "fogOfWar",				"true"	 },
@@ -64,6 +65,10 @@ namespace game::_internal {
 						{ "npcMoveChance",			 "6.0"	},
 						{ "npcMoveChanceAggro",		 "6.0"	},
 						{ "npcVisModAggro",			 "1"	},
+						{ "npcLodNearRange",		 "24"	},
+						{ "npcLodFarRange",			 "64"	},
+						{ "npcLodMidRate",			 "2"	},
+						{ "npcLodFarRate",			 "8"	},
 				        { "multStatsByLevel",       "false" },
 						{ "regen_time",				 "2"	},
 						{ "regen_health",			 "5"	},
@@ -98,7 +103,11 @@ namespace game::_internal {
 				{
 					"timing", {
 						{ "framerate",		"75"	 },
+						{ "tickrate",		"60"	 },
 						{ "npc_cycle",		"225"	 },
+						{ "headless",		"false"  },
+						{ "headless_ticks",	"0"		 },
+						{ "showFrameStats",	"false"  },
 					}
 				},
 			};/*,
@@ -108,6 +117,7 @@ namespace game::_internal {
 					"world", {
 						{ "sizeH", "Horizontal World Size" },
 						{ "sizeV", "Vertical World Size" },
+						{ "seed", "World seed, the same seed always generates the same game. When 0, a random seed is used." },
 						{ "showAllTiles", "When true, all tiles are always visible" },
 						{ "showAllWalls", "When true, all walls are always visible" },
 						{ "fogOfWar", "When true, tile discovery is turned off, and only nearby tiles are visible" },
@@ -121,6 +131,10 @@ namespace game::_internal {
 						{ "attackMissChanceDrained", "The chance that an actor will miss an attack when they are out of stamina" },
 						{ "npcMoveChance", "Every NPC cycle, there is a 1 in (x) chance of an NPC moving." },
 						{ "npcMoveChanceAggro", "Every NPC cycle, there is a 1 in (x) chance of an NPC moving when they have an active target." },
+						{ "npcLodNearRange", "NPCs whose vision reaches within (x) tiles of the player act every NPC cycle." },
+						{ "npcLodFarRange", "NPCs whose vision doesn't reach within (x) tiles of the player act every npcLodFarRate cycles, the rest act every npcLodMidRate cycles." },
+						{ "npcLodMidRate", "NPCs at a medium distance from the player act once every (x) NPC cycles." },
+						{ "npcLodFarRate", "NPCs far away from the player act once every (x) NPC cycles." },
 						{ "regen_time", "Every (x) seconds, all actors regen an amount of their health & stamina" },
 						{ "levelRestorePercent", "Every time an actor levels up, this percentage of their stats are regenerated instantly." },
 					}
@@ -128,7 +142,11 @@ namespace game::_internal {
 				{
 					"timing", {
 						{ "framerate", "Target/Max frames per second" },
+						{ "tickrate", "Simulation ticks per second. NPC cycles, regen & flares are counted in ticks." },
 						{ "npc_cycle", "Time between NPC cycles in milliseconds." },
+						{ "headless", "When true, the simulation runs as fast as possible without a display or player input." },
+						{ "headless_ticks", "The number of ticks to run in headless mode, or 0 to run until the game is over." },
+						{ "showFrameStats", "When true, the number of bytes used to draw each frame is shown below the player stats." },
 					}
 				},
 				{
@@ -186,7 +204,7 @@ namespace game::_internal {
 
 		/**
 		 * initTiming(INI&)
-		 * @brief Initialize timing values for the display thread & npc thread. Sets framerate/time & npcCycle time.
+		 * @brief Initialize timing values for the game loop. Sets framerate/time, tickrate/time, npcCycle time & headless mode.
 		 * @param cfg		- INI instance ref, only the [timing] section is used.
 		 * @return true		- Successfully initialized timing values.
 		 * @return false	- An exception occurred.
@@ -194,13 +212,17 @@ namespace game::_internal {
 		inline bool initTiming(file::INI& cfg) noexcept
 		{
 			try {
-				if ( setFramerate(cfg.get<unsigned int>("timing", "framerate", str::stoui).value_or(60u)) && setNPCCycle(cfg.get<unsigned int>("timing", "npc_cycle", str::stoui).value_or(225u)) )
+				__HEADLESS = cfg.get<bool>("timing", "headless", str::stob).value_or(false);
+				__HEADLESS_TICKS = cfg.get<unsigned int>("timing", "headless_ticks", str::stoui).value_or(0u);
+				if ( setFramerate(cfg.get<unsigned int>("timing", "framerate", str::stoui).value_or(60u)) && setTickrate(cfg.get<unsigned int>("timing", "tickrate", str::stoui).value_or(60u)) && setNPCCycle(cfg.get<unsigned int>("timing", "npc_cycle", str::stoui).value_or(225u)) )
 					std::cout << sys::debug << "Game timings were set successfully." << std::endl;
 				return true;
 			} catch ( ... ) {
 				setFramerate(60);
+				setTickrate(60);
 				setNPCCycle(225);
-				std::cout << sys::warn << "Invalid 'INI -> [timing]' settings caused an exception, framerate & npc cycle times were set to default." << std::endl;
+				__HEADLESS = false;
+				std::cout << sys::warn << "Invalid 'INI -> [timing]' settings caused an exception, framerate, tickrate & npc cycle times were set to default." << std::endl;
 				return false;
 			}
 		}
@@ -18,27 +18,22 @@ protected:
 	// General stats
 	std::string _name;					// The name of this item
 	int _use_count;						// When this value reaches 0, the item should be deleted.
-	std::vector<FACTION> _faction_lock; // List of factions that may use this item
+	FactionMask _faction_lock;			// Mask of factions that may use this item
 
 	/**
 	 * initFactionLock()
-	 * Initializes this item's _faction_lock vector to allow any faction to use this item.
+	 * Initializes this item's _faction_lock mask to allow any faction to use this item.
 	 */
-	void initFactionLock()
-	{
-		for ( auto i = static_cast<int>(FACTION::PLAYER); i < static_cast<int>(FACTION::NONE); i++ ) {
-			_faction_lock.push_back(static_cast<FACTION>(i));
-		}
-	}
+	void initFactionLock() { _faction_lock = FACTION_MASK_MEMBERS; }
 
 	/**
 	 * canUse(FACTION)
-	 * Checks if a given faction is allowed to use this item by comparing against the _faction_lock vec.
+	 * Checks if a given faction is allowed to use this item by comparing against the _faction_lock mask.
 	 *
 	 * @param f		 - A faction
 	 * @returns bool - ( true = faction can use item ) ( false = faction cannot use item )
 	 */
-	bool canUse(const FACTION f) { for ( auto it : _faction_lock ) if ( it == f ) return true; return false; }
+	[[nodiscard]] bool canUse(const FACTION f) const { return ( _faction_lock & factionBit(f) ) != 0u; }
 
 public:
 
@@ -76,7 +71,7 @@ public:
 	 * @param maxUses		- The number of times this item can be used before being removed.
 	 * @param canBeUsedBy	- Vector of factions allowed to use this item.
 	 */
-	ItemStats(const char display, const unsigned short displayColor, std::string name, const int maxUses, std::vector<FACTION> canBeUsedBy) : _char(display), _color(displayColor), _name(std::move(name)), _use_count(maxUses), _faction_lock(std::move(canBeUsedBy)) {}
+	ItemStats(const char display, const unsigned short displayColor, std::string name, const int maxUses, const std::vector<FACTION>& canBeUsedBy) : _char(display), _color(displayColor), _name(std::move(name)), _use_count(maxUses), _faction_lock(factionMask(canBeUsedBy)) {}
 
 #pragma region DEFAULT
 	// Default constructors/destructor/operators
@@ -155,7 +150,7 @@ public:
 	 * @param myPos			- Ref to a coord position
 	 * @param lockToFaction	- Vector of factions allowed to use this item
 	 */
-	ItemStaticBase(const char display, const unsigned short displayColor, std::string myName, const int myUses, const Coord& myPos, std::vector<FACTION> lockToFaction) : ItemStats(display, displayColor, std::move(myName), myUses, std::move(lockToFaction)), _pos(myPos) {}
+	ItemStaticBase(const char display, const unsigned short displayColor, std::string myName, const int myUses, const Coord& myPos, const std::vector<FACTION>& lockToFaction) : ItemStats(display, displayColor, std::move(myName), myUses, lockToFaction), _pos(myPos) {}
 
 	/**
 	 * ItemStaticBase(ItemStats&, Coord&)
@@ -254,7 +249,7 @@ public:
 	 * @param amountRestored	- The amount of health this item restores
 	 * @param lockToFaction		- Vector of factions allowed to use this item
 	 */
-	ItemStaticHealth(const Coord& myPos, const int amountRestored, std::vector<FACTION> lockToFaction) : ItemStaticBase('&', Color::_b_red, "Restore Health", 1, myPos, std::move(lockToFaction)), _amount(amountRestored) {}
+	ItemStaticHealth(const Coord& myPos, const int amountRestored, const std::vector<FACTION>& lockToFaction) : ItemStaticBase('&', Color::_b_red, "Restore Health", 1, myPos, lockToFaction), _amount(amountRestored) {}
 #pragma region DEFAULT
 	// Default constructors/destructor/operators
 	ItemStaticHealth(const ItemStaticHealth&) = default;
@@ -311,7 +306,7 @@ public:
 	 * @param amountRestored	- The amount of stamina this item restores
 	 * @param lockToFaction		- Vector of factions allowed to use this item
 	 */
-	ItemStaticStamina(const Coord& myPos, const int amountRestored, std::vector<FACTION> lockToFaction) : ItemStaticBase('&', Color::_b_green, "Restore Health", 1, myPos, std::move(lockToFaction)), _amount(amountRestored) {}
+	ItemStaticStamina(const Coord& myPos, const int amountRestored, const std::vector<FACTION>& lockToFaction) : ItemStaticBase('&', Color::_b_green, "Restore Health", 1, myPos, lockToFaction), _amount(amountRestored) {}
 
 #pragma region DEFAULT
 	// Default constructors/destructor/operators
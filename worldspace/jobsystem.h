@@ -0,0 +1,283 @@
+/**
+ * @file jobsystem.h
+ * @author radj307
+ * @brief Contains the JobSystem class, a small work-stealing thread pool that runs tasks with dependencies.
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class JobSystem
+ * @brief Thread pool where each worker has its own queue of jobs. \n
+ * Workers take jobs from the back of their own queue, and when it is empty they steal from the front of another worker's queue, so load spreads across every core without a single shared queue. \n
+ * A job can depend on other jobs, in which case it is only queued once all of them have finished. \n
+ * Threads that wait for a job help run queued jobs in the meantime, so waiting from inside a job never deadlocks.
+ */
+class JobSystem final {
+public:
+	/**
+	 * @struct Job
+	 * @brief A single unit of work, and the jobs that are waiting for it to finish.
+	 */
+	struct Job final {
+		std::function<void()> _work;					///< @brief The function to run.
+		std::atomic<unsigned> _pending{ 1u };			///< @brief The number of unfinished dependencies, plus one while the job is being submitted.
+		std::atomic<bool> _done{ false };				///< @brief Set once the job finished running.
+		std::exception_ptr _error;						///< @brief The exception thrown by the job, if any. This is rethrown by wait().
+		std::mutex _lock;								///< @brief Guards _dependents.
+		std::vector<std::shared_ptr<Job>> _dependents;	///< @brief Jobs that depend on this one.
+	};
+	using Handle = std::shared_ptr<Job>; ///< @brief Reference to a submitted job, used to wait for it or to depend on it.
+
+private:
+	/**
+	 * @struct Queue
+	 * @brief The job queue of a single thread. The owner uses the back, thieves use the front.
+	 */
+	struct Queue final {
+		std::mutex _lock;
+		std::deque<Handle> _jobs;
+	};
+
+	std::vector<std::unique_ptr<Queue>> _queues;	///< @brief One queue per worker, plus queue 0 which is shared by every thread outside of the pool.
+	std::vector<std::thread> _workers;				///< @brief The worker threads.
+	std::atomic<size_t> _queued{ 0u };				///< @brief The total number of jobs waiting in all queues.
+	std::atomic<bool> _stop{ false };				///< @brief Set when the pool is being destroyed.
+	std::mutex _sleep_lock;							///< @brief Used with _wake to put idle workers to sleep.
+	std::condition_variable _wake;					///< @brief Signalled when a job is queued, or the pool is stopping.
+
+	static inline thread_local const JobSystem* _owner{ nullptr };	///< @brief The pool that the current thread is a worker of.
+	static inline thread_local size_t _index{ 0u };				///< @brief The queue index of the current thread, if it is a worker.
+
+	/**
+	 * current()
+	 * @brief Returns the queue index of the calling thread, or 0 if it isn't one of this pool's workers.
+	 * @returns size_t
+	 */
+	[[nodiscard]] size_t current() const noexcept { return _owner == this ? _index : 0u; }
+
+	/**
+	 * schedule(Handle)
+	 * @brief Adds a job that is ready to run to the calling thread's queue, and wakes an idle worker.
+	 * @param job	- The job to queue.
+	 */
+	void schedule(Handle job)
+	{
+		++_queued; // counted before it is visible, so the count never drops below zero when the job is taken straight away
+		{
+			auto& queue{ *_queues[current()] };
+			std::scoped_lock lock(queue._lock);
+			queue._jobs.push_back(std::move(job));
+		}
+		{ std::scoped_lock lock(_sleep_lock); } // a worker that just checked _queued is now waiting, so it can't miss the notification
+		_wake.notify_one();
+	}
+
+	/**
+	 * take(size_t)
+	 * @brief Takes the next job for a thread, from the back of its own queue or else from the front of another queue.
+	 * @param self		- The queue index of the calling thread.
+	 * @returns Handle	- The job, or nullptr if every queue is empty.
+	 */
+	Handle take(const size_t self)
+	{
+		if ( _queued.load() == 0u )
+			return nullptr;
+		for ( size_t i{ 0u }; i < _queues.size(); ++i ) {
+			auto& queue{ *_queues[( self + i ) % _queues.size()] };
+			std::scoped_lock lock(queue._lock);
+			if ( !queue._jobs.empty() ) {
+				Handle job;
+				if ( i == 0u ) { // own queue, newest first
+					job = std::move(queue._jobs.back());
+					queue._jobs.pop_back();
+				}
+				else { // steal the oldest job
+					job = std::move(queue._jobs.front());
+					queue._jobs.pop_front();
+				}
+				--_queued;
+				return job;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * run(Handle&)
+	 * @brief Runs a job, marks it as done, and queues any dependents that have no unfinished dependencies left.
+	 * @param job	- The job to run.
+	 */
+	void run(const Handle& job)
+	{
+		try {
+			job->_work();
+		} catch ( ... ) {
+			job->_error = std::current_exception();
+		}
+		std::vector<Handle> dependents;
+		{
+			std::scoped_lock lock(job->_lock);
+			job->_done.store(true);
+			dependents.swap(job->_dependents);
+		}
+		for ( auto& dependent : dependents )
+			if ( --dependent->_pending == 0u )
+				schedule(std::move(dependent));
+	}
+
+	/**
+	 * work(size_t)
+	 * @brief The main loop of a worker thread.
+	 * @param self	- The queue index of this worker.
+	 */
+	void work(const size_t self)
+	{
+		_owner = this;
+		_index = self;
+		while ( !_stop.load() ) {
+			if ( const auto job{ take(self) } ) {
+				run(job);
+				continue;
+			}
+			std::unique_lock lock(_sleep_lock);
+			_wake.wait(lock, [this] { return _stop.load() || _queued.load() > 0u; });
+		}
+	}
+
+public:
+	/**
+	 * JobSystem(size_t)
+	 * @brief Create a pool and start its worker threads.
+	 * @param workers	- (Default: One less than the number of cores) The number of worker threads. The thread that waits for jobs also runs them, so this can be 0.
+	 */
+	explicit JobSystem(const size_t workers = std::thread::hardware_concurrency() > 1u ? std::thread::hardware_concurrency() - 1u : 0u)
+	{
+		_queues.reserve(workers + 1u);
+		for ( size_t i{ 0u }; i <= workers; ++i )
+			_queues.emplace_back(std::make_unique<Queue>());
+		_workers.reserve(workers);
+		for ( size_t i{ 1u }; i <= workers; ++i )
+			_workers.emplace_back(&JobSystem::work, this, i);
+	}
+	JobSystem(const JobSystem&) = delete;
+	JobSystem(JobSystem&&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+	JobSystem& operator=(JobSystem&&) = delete;
+	/**
+	 * ~JobSystem()
+	 * @brief Stops & joins the worker threads. Jobs that are still queued are discarded.
+	 */
+	~JobSystem()
+	{
+		{
+			std::scoped_lock lock(_sleep_lock);
+			_stop.store(true);
+		}
+		_wake.notify_all();
+		for ( auto& worker : _workers )
+			worker.join();
+	}
+
+	/**
+	 * concurrency()
+	 * @brief Returns the maximum number of jobs that can run at once, which is the number of workers plus the waiting thread.
+	 * @returns size_t
+	 */
+	[[nodiscard]] size_t concurrency() const noexcept { return _workers.size() + 1u; }
+
+	/**
+	 * submit(function<void()>, initializer_list<Handle>)
+	 * @brief Submits a job, which is queued once all of its dependencies have finished.
+	 * @param work		- The function to run.
+	 * @param deps		- (Default: {}) Jobs that must finish before this one starts. Null handles are ignored.
+	 * @returns Handle
+	 */
+	Handle submit(std::function<void()> work, const std::initializer_list<Handle> deps = {})
+	{
+		auto job{ std::make_shared<Job>() };
+		job->_work = std::move(work);
+		for ( const auto& dep : deps ) {
+			if ( dep == nullptr )
+				continue;
+			std::scoped_lock lock(dep->_lock);
+			if ( !dep->_done.load() ) {
+				++job->_pending;
+				dep->_dependents.push_back(job);
+			}
+		}
+		if ( --job->_pending == 0u ) // release the submission guard
+			schedule(job);
+		return job;
+	}
+
+	/**
+	 * wait(Handle&)
+	 * @brief Blocks until a job has finished, running other queued jobs in the meantime.
+	 * @throws Rethrows any exception thrown by the job.
+	 * @param job	- The job to wait for.
+	 */
+	void wait(const Handle& job)
+	{
+		if ( job == nullptr )
+			return;
+		const auto self{ current() };
+		while ( !job->_done.load() ) {
+			if ( const auto next{ take(self) } )
+				run(next);
+			else std::this_thread::yield();
+		}
+		if ( job->_error )
+			std::rethrow_exception(job->_error);
+	}
+
+	/**
+	 * parallel_for(size_t, size_t, Func&&)
+	 * @brief Splits a range into contiguous batches, and runs them across the pool. Returns once every batch has finished.
+	 * @throws Rethrows the first exception thrown by any batch, after every batch has finished.
+	 * @tparam Func		- Function type, with the signature void(size_t batch, size_t first, size_t last)
+	 * @param count		- The number of elements in the range.
+	 * @param minBatch	- The minimum number of elements in each batch, below this the scheduling overhead outweighs the work.
+	 * @param func		- The function to call for each batch. The batch index is less than concurrency(), so it can be used to select per-thread scratch buffers.
+	 */
+	template<typename Func>
+	void parallel_for(const size_t count, const size_t minBatch, Func&& func)
+	{
+		if ( count == 0u )
+			return;
+		auto batches{ ( count + ( minBatch > 0u ? minBatch : 1u ) - 1u ) / ( minBatch > 0u ? minBatch : 1u ) };
+		batches = batches > concurrency() ? concurrency() : batches;
+		const auto size{ ( count + batches - 1u ) / batches };
+		std::vector<Handle> jobs;
+		jobs.reserve(batches);
+		for ( size_t b{ 1u }; b < batches && b * size < count; ++b ) {
+			const auto first{ b * size }, last{ first + size < count ? first + size : count };
+			jobs.push_back(submit([&func, b, first, last] { func(b, first, last); }));
+		}
+		std::exception_ptr error;
+		try {
+			func(0u, 0u, size < count ? size : count);
+		} catch ( ... ) {
+			error = std::current_exception();
+		}
+		for ( const auto& job : jobs ) { // every batch must finish before func goes out of scope
+			try {
+				wait(job);
+			} catch ( ... ) {
+				if ( !error )
+					error = std::current_exception();
+			}
+		}
+		if ( error )
+			std::rethrow_exception(error);
+	}
+};
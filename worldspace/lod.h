@@ -0,0 +1,98 @@
+/**
+ * @file lod.h
+ * @author radj307
+ * @brief Contains the LODScheduler class, which decides how often each NPC acts based on its distance from the player.
+ */
+#pragma once
+#include "Coord.h"
+
+/**
+ * @enum LOD
+ * @brief The level-of-detail bucket of an NPC. NPCs in farther buckets act less often. \n
+ * The names aren't capitalized like other enums, as NEAR & FAR are macros defined by <minwindef.h>.
+ */
+enum class LOD : unsigned char {
+	Near = 0,	///< @brief Acts every NPC cycle.
+	Mid = 1,	///< @brief Acts once every few NPC cycles.
+	Far = 2,	///< @brief Acts rarely.
+};
+
+/**
+ * @class LODScheduler
+ * @brief Buckets NPCs by their distance from the player, and decides which NPCs act during each NPC cycle. \n
+ * NPCs in the Mid & Far buckets only act on one out of every few cycles. Each NPC's turn is offset by its entity id, so only a fraction of each bucket acts during any one cycle & the cost of a cycle stays roughly constant. \n
+ * Distances are measured from the edge of the NPC's vision range, so an NPC that can see far is kept in a nearer bucket. NPCs with an active target are always in the Near bucket.
+ */
+class LODScheduler final {
+	long
+		_near_range,			///< @brief NPCs whose vision reaches within this many tiles of the player are in the Near bucket.
+		_far_range;				///< @brief NPCs whose vision doesn't reach within this many tiles of the player are in the Far bucket.
+	unsigned
+		_mid_rate,				///< @brief NPCs in the Mid bucket act once every this many cycles.
+		_far_rate;				///< @brief NPCs in the Far bucket act once every this many cycles.
+	unsigned long long _cycle{ 0ull }; ///< @brief The number of NPC cycles that have started.
+
+public:
+	/**
+	 * LODScheduler(long, long, unsigned, unsigned)
+	 * @brief Create a scheduler with the given bucket ranges & rates.
+	 * @param nearRange	- The distance from the player that the Near bucket extends to, beyond the NPC's vision range.
+	 * @param farRange	- The distance from the player that the Far bucket starts at, beyond the NPC's vision range.
+	 * @param midRate	- The number of cycles between each action of an NPC in the Mid bucket. 0 is treated as 1.
+	 * @param farRate	- The number of cycles between each action of an NPC in the Far bucket. 0 is treated as 1.
+	 */
+	LODScheduler(const long nearRange, const long farRange, const unsigned midRate, const unsigned farRate) :
+		_near_range(nearRange > 0 ? nearRange : 0), _far_range(farRange > _near_range ? farRange : _near_range), _mid_rate(midRate > 0u ? midRate : 1u), _far_rate(farRate > 0u ? farRate : 1u) {}
+
+	/**
+	 * nearRange()
+	 * @brief Returns the distance beyond an NPC's vision range that the Near bucket extends to.
+	 * @returns long
+	 */
+	[[nodiscard]] long nearRange() const noexcept { return _near_range; }
+
+	/**
+	 * nextCycle()
+	 * @brief Starts a new NPC cycle. Call this once before checking which NPCs are due.
+	 */
+	void nextCycle() noexcept { ++_cycle; }
+
+	/**
+	 * due(LOD, size_t)
+	 * @brief Checks if an NPC should act during the current cycle.
+	 * @param bucket	- The NPC's current bucket.
+	 * @param phase		- A number that is different for each NPC & doesn't change while it exists, such as its entity id. This spreads the NPCs of a bucket over the cycles.
+	 * @returns bool
+	 */
+	[[nodiscard]] bool due(const LOD bucket, const size_t phase) const noexcept
+	{
+		switch ( bucket ) {
+		case LOD::Mid:
+			return ( _cycle + phase ) % _mid_rate == 0u;
+		case LOD::Far:
+			return ( _cycle + phase ) % _far_rate == 0u;
+		default:
+			return true;
+		}
+	}
+
+	/**
+	 * classify(Coord&, Coord&, int, bool)
+	 * @brief Returns the bucket that an NPC belongs in.
+	 * @param pos		- The NPC's position.
+	 * @param focus		- The player's position.
+	 * @param vis		- The NPC's vision range.
+	 * @param active	- When true, the NPC has a target or is aggravated, and is always placed in the Near bucket.
+	 * @returns LOD
+	 */
+	[[nodiscard]] LOD classify(const Coord& pos, const Coord& focus, const int vis, const bool active) const noexcept
+	{
+		if ( active )
+			return LOD::Near;
+		const auto dx{ pos._x - focus._x }, dy{ pos._y - focus._y };
+		const auto dist{ dx * dx + dy * dy }, nearDist{ vis + _near_range }, farDist{ vis + _far_range };
+		if ( dist <= nearDist * nearDist )
+			return LOD::Near;
+		return dist <= farDist * farDist ? LOD::Mid : LOD::Far;
+	}
+};
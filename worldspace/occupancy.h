@@ -0,0 +1,136 @@
+/**
+ * @file occupancy.h
+ * @author radj307
+ * @brief Contains the OccupancyGrid class, a per-tile index of the actors & static items located in a Cell.
+ */
+#pragma once
+#include <vector>
+
+#include "Coord.h"
+
+struct ActorBase;
+struct ItemStaticBase;
+
+/**
+ * @class OccupancyGrid
+ * @brief Per-tile lookup layer that is kept alongside a Cell. \n
+ * Each tile stores a handle to the actor & the static item currently located on it, which allows point queries in constant time without allocating. \n
+ * The grid does not own anything, the Gamespace is responsible for keeping it in sync when entities spawn, move, or are removed.
+ */
+class OccupancyGrid final {
+	Coord _size;							///< @brief The size of the grid, this should match the size of the attached Cell.
+	std::vector<ActorBase*> _actor;			///< @brief Actor layer, stored in row-major order.
+	std::vector<ItemStaticBase*> _item;		///< @brief Static item layer, stored in row-major order.
+
+	/**
+	 * index(long, long)
+	 * @brief Returns the row-major index of a given position. Does not check boundaries.
+	 * @param x		- X-axis (horizontal) index.
+	 * @param y		- Y-axis (vertical) index.
+	 * @returns size_t
+	 */
+	[[nodiscard]] size_t index( const long x, const long y ) const noexcept { return static_cast<size_t>(y) * static_cast<size_t>(_size._x) + static_cast<size_t>(x); }
+
+public:
+	const checkBounds isValidPos; ///< @brief Functor that can be used to check if a point is within the boundaries of the grid.
+
+	/**
+	 * OccupancyGrid(Coord&)
+	 * @brief Create an empty occupancy grid of the given size.
+	 * @param size	- The size of the grid, this should be the _max member of the attached Cell.
+	 */
+	explicit OccupancyGrid( const Coord& size ) : _size( size ), _actor( static_cast<size_t>(size._x) * static_cast<size_t>(size._y), nullptr ), _item( _actor.size(), nullptr ), isValidPos( _size ) {}
+
+	/**
+	 * getActor(long, long)
+	 * @brief Returns the actor located at a given tile.
+	 * @param x				- X-axis (horizontal) index.
+	 * @param y				- Y-axis (vertical) index.
+	 * @returns ActorBase*	- nullptr if the tile is empty, or the position is invalid.
+	 */
+	[[nodiscard]] ActorBase* getActor( const long x, const long y ) const noexcept { return isValidPos( x, y ) ? _actor[index( x, y )] : nullptr; }
+	/**
+	 * getActor(Coord&)
+	 * @brief Returns the actor located at a given tile.
+	 * @param pos			- Target position.
+	 * @returns ActorBase*	- nullptr if the tile is empty, or the position is invalid.
+	 */
+	[[nodiscard]] ActorBase* getActor( const Coord& pos ) const noexcept { return getActor( pos._x, pos._y ); }
+
+	/**
+	 * getItem(long, long)
+	 * @brief Returns the static item located at a given tile.
+	 * @param x					- X-axis (horizontal) index.
+	 * @param y					- Y-axis (vertical) index.
+	 * @returns ItemStaticBase*	- nullptr if the tile is empty, or the position is invalid.
+	 */
+	[[nodiscard]] ItemStaticBase* getItem( const long x, const long y ) const noexcept { return isValidPos( x, y ) ? _item[index( x, y )] : nullptr; }
+	/**
+	 * getItem(Coord&)
+	 * @brief Returns the static item located at a given tile.
+	 * @param pos				- Target position.
+	 * @returns ItemStaticBase*	- nullptr if the tile is empty, or the position is invalid.
+	 */
+	[[nodiscard]] ItemStaticBase* getItem( const Coord& pos ) const noexcept { return getItem( pos._x, pos._y ); }
+
+	/**
+	 * setActor(Coord&, ActorBase*)
+	 * @brief Sets the actor handle of a given tile, overwriting any previous value.
+	 * @param pos	- Target position.
+	 * @param actor	- Actor handle, or nullptr to clear the tile.
+	 */
+	void setActor( const Coord& pos, ActorBase* actor ) noexcept
+	{
+		if ( isValidPos( pos ) )
+			_actor[index( pos._x, pos._y )] = actor;
+	}
+
+	/**
+	 * setItem(Coord&, ItemStaticBase*)
+	 * @brief Sets the item handle of a given tile, overwriting any previous value.
+	 * @param pos	- Target position.
+	 * @param item	- Item handle, or nullptr to clear the tile.
+	 */
+	void setItem( const Coord& pos, ItemStaticBase* item ) noexcept
+	{
+		if ( isValidPos( pos ) )
+			_item[index( pos._x, pos._y )] = item;
+	}
+
+	/**
+	 * removeActor(Coord&, ActorBase*)
+	 * @brief Clears a tile's actor handle, only if it currently points to the given actor.
+	 * @param pos	- Target position.
+	 * @param actor	- The actor to remove.
+	 */
+	void removeActor( const Coord& pos, const ActorBase* actor ) noexcept
+	{
+		if ( isValidPos( pos ) && _actor[index( pos._x, pos._y )] == actor )
+			_actor[index( pos._x, pos._y )] = nullptr;
+	}
+
+	/**
+	 * removeItem(Coord&, ItemStaticBase*)
+	 * @brief Clears a tile's item handle, only if it currently points to the given item.
+	 * @param pos	- Target position.
+	 * @param item	- The item to remove.
+	 */
+	void removeItem( const Coord& pos, const ItemStaticBase* item ) noexcept
+	{
+		if ( isValidPos( pos ) && _item[index( pos._x, pos._y )] == item )
+			_item[index( pos._x, pos._y )] = nullptr;
+	}
+
+	/**
+	 * moveActor(ActorBase*, Coord&, Coord&)
+	 * @brief Moves an actor handle from one tile to another.
+	 * @param actor	- The actor that moved.
+	 * @param from	- The actor's previous position.
+	 * @param to	- The actor's current position.
+	 */
+	void moveActor( ActorBase* actor, const Coord& from, const Coord& to ) noexcept
+	{
+		removeActor( from, actor );
+		setActor( to, actor );
+	}
+};
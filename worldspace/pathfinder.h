@@ -0,0 +1,246 @@
+/**
+ * @file pathfinder.h
+ * @author radj307
+ * @brief Contains the Pathfinder class, an A* search over a passability plane, and the PathCursor struct used by NPCs to follow its results.
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "bitplane.h"
+
+/**
+ * @struct PathCursor
+ * @brief Stores a path returned by the Pathfinder, and tracks how long it has been followed. \n
+ * A path is followed for several ticks before it is replanned, so that an NPC chasing a moving target doesn't run a full search every tick.
+ */
+struct PathCursor final {
+	static constexpr unsigned REPLAN_TICKS{ 8u };	///< @brief The maximum number of steps to take along a path before it is replanned.
+	static constexpr long REPLAN_DISTANCE{ 2L };	///< @brief The maximum number of tiles the goal can move before the path is replanned.
+
+	std::vector<Coord> _steps;	///< @brief The remaining steps of the current segment, in reverse order so that the next step is at the back.
+	std::vector<Coord> _waypoints; ///< @brief The remaining waypoints of a long path, in reverse order. Each one is refined into _steps when the previous segment is finished.
+	Coord _goal{};				///< @brief The goal position the path was planned towards.
+	unsigned _version{ 0u };	///< @brief The move version of the cell when the path was planned.
+	unsigned _age{ 0u };		///< @brief The number of steps taken since the path was planned.
+	unsigned _cooldown{ 0u };	///< @brief The number of ticks to wait before searching again, after a search failed.
+
+	/**
+	 * clear()
+	 * @brief Discards the current path, so a new one is planned the next time the NPC moves.
+	 */
+	void clear() noexcept
+	{
+		_steps.clear();
+		_waypoints.clear();
+		_age = 0u;
+		_cooldown = 0u;
+	}
+
+	/**
+	 * empty()
+	 * @brief Checks if there are no steps remaining in the current segment.
+	 * @returns bool
+	 */
+	[[nodiscard]] bool empty() const noexcept { return _steps.empty(); }
+
+	/**
+	 * needsRefine()
+	 * @brief Checks if the current segment is finished, and there are waypoints remaining that should be refined into the next segment.
+	 * @returns bool
+	 */
+	[[nodiscard]] bool needsRefine() const noexcept { return _steps.empty() && !_waypoints.empty(); }
+
+	/**
+	 * next()
+	 * @brief Returns the next step of the path. The path must not be empty.
+	 * @returns Coord&
+	 */
+	[[nodiscard]] const Coord& next() const noexcept { return _steps.back(); }
+
+	/**
+	 * advance()
+	 * @brief Removes the next step of the path, this should be called after the NPC moved to it.
+	 */
+	void advance() noexcept
+	{
+		_steps.pop_back();
+		++_age;
+	}
+
+	/**
+	 * valid(Coord&, Coord&, unsigned)
+	 * @brief Checks if the remaining path can still be followed, or if it should be replanned.
+	 * @param pos		- The NPC's current position.
+	 * @param goal		- The current position of the NPC's target.
+	 * @param version	- The cell's current move version.
+	 * @returns bool	- ( true = Path can be followed ) ( false = Path should be replanned )
+	 */
+	[[nodiscard]] bool valid(const Coord& pos, const Coord& goal, const unsigned version) const noexcept
+	{
+		if ( ( _steps.empty() && _waypoints.empty() ) || version != _version || _age >= REPLAN_TICKS )
+			return false;
+		const auto gx{ goal._x - _goal._x }, gy{ goal._y - _goal._y };
+		if ( ( gx < 0 ? -gx : gx ) + ( gy < 0 ? -gy : gy ) > REPLAN_DISTANCE )
+			return false;
+		if ( _steps.empty() )
+			return true; // the next segment hasn't been refined yet
+		// the next step must be adjacent to the NPC
+		const auto sx{ _steps.back()._x - pos._x }, sy{ _steps.back()._y - pos._y };
+		return ( sx < 0 ? -sx : sx ) + ( sy < 0 ? -sy : sy ) == 1;
+	}
+
+	/**
+	 * canSearch()
+	 * @brief Checks if a new search may be performed this tick, and counts down the cooldown if it can't.
+	 * @returns bool
+	 */
+	[[nodiscard]] bool canSearch() noexcept
+	{
+		if ( _cooldown == 0u )
+			return true;
+		--_cooldown;
+		return false;
+	}
+
+	/**
+	 * reset(Coord&, unsigned, bool)
+	 * @brief Records the goal & version of a new search. This should be called after filling _steps with Pathfinder::find().
+	 * @param goal		- The goal position that was searched for.
+	 * @param version	- The cell's move version at the time of the search.
+	 * @param found		- The result of the search, when false the next search is delayed by REPLAN_TICKS.
+	 */
+	void reset(const Coord& goal, const unsigned version, const bool found) noexcept
+	{
+		_goal = goal;
+		_version = version;
+		_age = 0u;
+		_cooldown = found ? 0u : REPLAN_TICKS;
+	}
+};
+
+/**
+ * @class Pathfinder
+ * @brief Finds the shortest path between two tiles using A* with a manhattan distance heuristic. \n
+ * Node storage is allocated once & reused for every search. Instead of clearing it, each search increments a generation counter, and any node stamped with an older generation is treated as unvisited.
+ */
+class Pathfinder final {
+	using Node = std::pair<int, std::uint32_t>; ///< @brief Heap entry, holds the estimated total cost & the index of the node.
+
+	Coord _size;							///< @brief The size of the searchable area, this should match the size of the attached Cell.
+	size_t _max_nodes;						///< @brief The maximum number of nodes expanded by a single search, before it gives up.
+	unsigned _generation{ 0u };				///< @brief The generation of the current search.
+	std::vector<unsigned> _seen;			///< @brief The generation that each node was last reached in. Nodes with an older generation are unvisited.
+	std::vector<unsigned> _closed;			///< @brief The generation that each node was last expanded in.
+	std::vector<int> _cost;					///< @brief The cost of the shortest known path from the start to each node.
+	std::vector<std::uint32_t> _parent;		///< @brief The previous node on the shortest known path to each node.
+	std::vector<Node> _heap;				///< @brief The open list, a binary min-heap.
+
+	/**
+	 * index(long, long)
+	 * @brief Returns the row-major index of a given position. Does not check boundaries.
+	 * @param x		- X-axis (horizontal) index.
+	 * @param y		- Y-axis (vertical) index.
+	 * @returns uint32_t
+	 */
+	[[nodiscard]] std::uint32_t index(const long x, const long y) const noexcept { return static_cast<std::uint32_t>(y * _size._x + x); }
+
+	/**
+	 * next_generation()
+	 * @brief Begins a new search by incrementing the generation, only clearing the node stamps when the counter wraps around.
+	 */
+	void next_generation()
+	{
+		if ( ++_generation == 0u ) {
+			std::fill(_seen.begin(), _seen.end(), 0u);
+			std::fill(_closed.begin(), _closed.end(), 0u);
+			_generation = 1u;
+		}
+		_heap.clear();
+	}
+
+	/**
+	 * push(int, uint32_t)
+	 * @brief Adds a node to the open list.
+	 * @param estimate	- The estimated total cost of a path through this node.
+	 * @param i			- Index of the node.
+	 */
+	void push(const int estimate, const std::uint32_t i)
+	{
+		_heap.emplace_back(estimate, i);
+		std::push_heap(_heap.begin(), _heap.end(), std::greater<>{});
+	}
+
+public:
+	/**
+	 * Pathfinder(Coord&, size_t)
+	 * @brief Create a pathfinder for an area of the given size.
+	 * @param size		- The size of the searchable area, this should be the _max member of the attached Cell.
+	 * @param maxNodes	- (Default: 4096) The maximum number of nodes a single search can expand before it gives up.
+	 */
+	explicit Pathfinder(const Coord& size, const size_t maxNodes = 4096u) :
+		_size(size._x > 0 ? size._x : 0, size._y > 0 ? size._y : 0), _max_nodes(maxNodes),
+		_seen(static_cast<size_t>(_size._x * _size._y), 0u), _closed(_seen.size(), 0u), _cost(_seen.size(), 0), _parent(_seen.size(), 0u) {}
+
+	/**
+	 * find(BitPlane&, Coord&, Coord&, vector<Coord>&)
+	 * @brief Searches for the shortest path between two tiles, moving orthogonally.
+	 * @param passable	- The canMove plane of the cell.
+	 * @param from		- The starting position.
+	 * @param to		- The goal position. This tile doesn't have to be passable, as it is usually occupied by the target.
+	 * @param out		- Receives the path, excluding the starting position, in reverse order so that the first step is at the back. This is cleared first.
+	 * @returns bool	- ( true = A path was found ) ( false = The goal is unreachable, or the search expanded too many nodes )
+	 */
+	bool find(const BitPlane& passable, const Coord& from, const Coord& to, std::vector<Coord>& out)
+	{
+		out.clear();
+		const auto inBounds{ [this](const Coord& p) { return p._x >= 0 && p._y >= 0 && p._x < _size._x && p._y < _size._y; } };
+		if ( !inBounds(from) || !inBounds(to) || from == to )
+			return false;
+		next_generation();
+		const auto heuristic{ [&to](const long x, const long y) { return static_cast<int>(( x < to._x ? to._x - x : x - to._x ) + ( y < to._y ? to._y - y : y - to._y )); } };
+		const auto start{ index(from._x, from._y) }, goal{ index(to._x, to._y) };
+		_seen[start] = _generation;
+		_cost[start] = 0;
+		_parent[start] = start;
+		push(heuristic(from._x, from._y), start);
+
+		for ( size_t expanded{ 0u }; !_heap.empty(); ) {
+			std::pop_heap(_heap.begin(), _heap.end(), std::greater<>{});
+			const auto i{ _heap.back().second };
+			_heap.pop_back();
+			if ( _closed[i] == _generation )
+				continue; // stale entry, this node was already expanded with a lower cost
+			_closed[i] = _generation;
+			if ( i == goal ) { // walk back along the parents to build the path
+				for ( auto n{ goal }; n != start; n = _parent[n] )
+					out.emplace_back(static_cast<long>(n % static_cast<std::uint32_t>(_size._x)), static_cast<long>(n / static_cast<std::uint32_t>(_size._x)));
+				return true;
+			}
+			if ( ++expanded > _max_nodes )
+				break;
+			const auto x{ static_cast<long>(i % static_cast<std::uint32_t>(_size._x)) }, y{ static_cast<long>(i / static_cast<std::uint32_t>(_size._x)) };
+			const auto visit{ [&, i](const long nx, const long ny) {
+				if ( nx < 0 || ny < 0 || nx >= _size._x || ny >= _size._y )
+					return;
+				const auto n{ index(nx, ny) };
+				if ( _closed[n] == _generation || ( n != goal && !passable.get(nx, ny) ) )
+					return;
+				const auto cost{ _cost[i] + 1 };
+				if ( _seen[n] != _generation || cost < _cost[n] ) {
+					_seen[n] = _generation;
+					_cost[n] = cost;
+					_parent[n] = i;
+					push(cost + heuristic(nx, ny), n);
+				}
+			} };
+			visit(x, y - 1);
+			visit(x, y + 1);
+			visit(x - 1, y);
+			visit(x + 1, y);
+		}
+		return false;
+	}
+};
@@ -0,0 +1,82 @@
+/**
+ * @file rng.h
+ * @author radj307
+ * @brief Contains the CounterRNG class, a small counter-based random number generator with one independent stream per entity.
+ */
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @class CounterRNG
+ * @brief Counter-based random number generator, 16 bytes in size. \n
+ * Each draw hashes a key & an incrementing counter with the SplitMix64 finalizer, so the n-th draw of a stream only depends on the key and n. \n
+ * The key is derived from a world seed & a stream id, so every entity can own its own stream, and the whole game is reproducible from the world seed. \n
+ * Streams with different ids are independent, so separate threads can draw from separate streams without any synchronization.
+ */
+class CounterRNG final {
+	std::uint64_t _key;			///< @brief The key of this stream, derived from the seed & stream id.
+	std::uint64_t _counter{ 0ull }; ///< @brief The number of values drawn from this stream.
+
+	/**
+	 * mix(uint64_t)
+	 * @brief The SplitMix64 finalizer, a bijective hash with good avalanche behaviour.
+	 * @param z			- Value to hash.
+	 * @returns uint64_t
+	 */
+	[[nodiscard]] static constexpr std::uint64_t mix(std::uint64_t z) noexcept
+	{
+		z = ( z ^ ( z >> 30u ) ) * 0xBF58476D1CE4E5B9ull;
+		z = ( z ^ ( z >> 27u ) ) * 0x94D049BB133111EBull;
+		return z ^ ( z >> 31u );
+	}
+
+public:
+	/**
+	 * CounterRNG(uint64_t, uint64_t)
+	 * @brief Create a random number stream.
+	 * @param seed		- (Default: 0) The world seed.
+	 * @param stream	- (Default: 0) The stream id, such as the id of the entity that owns this stream.
+	 */
+	explicit constexpr CounterRNG(const std::uint64_t seed = 0ull, const std::uint64_t stream = 0ull) noexcept : _key(mix(mix(seed) ^ ( stream * 0x9E3779B97F4A7C15ull + 0x632BE59BD9B4E019ull ))) {}
+
+	/**
+	 * next()
+	 * @brief Returns the next raw 64-bit value of this stream.
+	 * @returns uint64_t
+	 */
+	[[nodiscard]] constexpr std::uint64_t next() noexcept { return mix(_key + ++_counter * 0x9E3779B97F4A7C15ull); }
+
+	/**
+	 * get(T, T)
+	 * @brief Returns a random number between min & max. Integers include both bounds, floating-points include min but not max.
+	 * @tparam T		- An arithmetic type.
+	 * @param max		- The upper bound.
+	 * @param min		- The lower bound.
+	 * @returns T
+	 */
+	template<typename T> requires std::is_arithmetic_v<T>
+	[[nodiscard]] T get(const T max, const T min) noexcept
+	{
+		if ( !( min < max ) )
+			return min;
+		if constexpr ( std::is_floating_point_v<T> ) {
+			const auto unit{ static_cast<double>(next() >> 11u) * ( 1.0 / 9007199254740992.0 ) }; // 53 bits, [0, 1)
+			return static_cast<T>(static_cast<double>(min) + unit * ( static_cast<double>(max) - static_cast<double>(min) ));
+		}
+		else {
+			// multiply-shift maps 32 random bits onto the range, ranges are always much smaller than 2^32 in this game
+			const auto range{ static_cast<std::uint64_t>(static_cast<std::int64_t>(max) - static_cast<std::int64_t>(min)) + 1ull };
+			return static_cast<T>(static_cast<std::int64_t>(min) + static_cast<std::int64_t>(( ( next() >> 32u ) * range ) >> 32u));
+		}
+	}
+
+	/**
+	 * get(T, U)
+	 * @brief Returns a random number between min & max, using the common type of both bounds.
+	 * @param max		- The upper bound.
+	 * @param min		- The lower bound.
+	 */
+	template<typename T, typename U> requires std::is_arithmetic_v<T> && std::is_arithmetic_v<U>
+	[[nodiscard]] auto get(const T max, const U min) noexcept { return get<std::common_type_t<T, U>>(static_cast<std::common_type_t<T, U>>(max), static_cast<std::common_type_t<T, U>>(min)); }
+};
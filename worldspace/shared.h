@@ -23,10 +23,15 @@ namespace game::_internal {
 	 */
 	constexpr auto calcFrametime(const unsigned int fps) { return std::chrono::milliseconds(1000) / fps; }
 
-	static unsigned int __FRAMERATE; ///< Target framerate, aka display cycles per second
+	static unsigned int
+		__FRAMERATE, ///< Target framerate, aka display cycles per second
+		__TICKRATE; ///< Simulation ticks per second. Every tick advances the game by the same amount of time, regardless of the framerate.
 	static std::chrono::duration<float> 
 		__FRAMETIME, ///< Target frametime, aka display cycle delay
+		__TICKTIME, ///< Length of a single simulation tick
 		__NPC_CLOCK; ///< Target NPC Cycle, aka NPC action delay.
+	static bool __HEADLESS; ///< When true, the simulation runs as fast as possible without a display or player input.
+	static unsigned long long __HEADLESS_TICKS; ///< The number of ticks to run in headless mode, or 0 to run until the game is over.
 
 	/**
 	 * setFramerate(unsigned int)
@@ -46,6 +51,36 @@ namespace game::_internal {
 		}
 	}
 
+	/**
+	 * setTickrate(unsigned int)
+	 * @brief Set the number of simulation ticks per second.
+	 * @param newTickrate	- In ticks per second, 0 is treated as 1.
+	 */
+	inline bool setTickrate(const unsigned int newTickrate)
+	{
+		try {
+			__TICKRATE = newTickrate > 0u ? newTickrate : 1u;
+			__TICKTIME = std::chrono::duration<float>{ 1.0f / static_cast<float>(__TICKRATE) };
+			return true;
+		} catch ( ... ) {
+			__TICKRATE = 60u;
+			__TICKTIME = std::chrono::duration<float>{ 1.0f / 60.0f };
+			return false;
+		}
+	}
+
+	/**
+	 * toTicks(duration<float>)
+	 * @brief Converts a duration to the nearest whole number of simulation ticks, using the current tickrate.
+	 * @param time	- The duration to convert.
+	 * @returns unsigned long long	- The number of ticks, this is always at least 1.
+	 */
+	inline unsigned long long toTicks(const std::chrono::duration<float> time)
+	{
+		const auto ticks{ static_cast<unsigned long long>(time.count() * static_cast<float>(__TICKRATE) + 0.5f) };
+		return ticks > 0ull ? ticks : 1ull;
+	}
+
 	/**
 	 * setNPCCycle(unsigned int)
 	 * @brief Set the amount of time between each NPC action cycle.
@@ -76,26 +111,33 @@ namespace game::_internal {
 		///< This is an optional string used to display the name of the actor who killed the player. This is only set by the game::start() function
 		
 		/**
-		 * pause_game(Coord)
-		 * @brief Sets the pause flag, clears the screen, and prints the pause message to a given pos.
-		 * @param textPos	- Location in the screen buffer to display the pause message
+		 * pause_game()
+		 * @brief Sets the pause flag. Only the simulation thread calls this, the display thread shows the pause screen when it sees the flag.
 		 */
-		void pause_game(const Coord textPos = Coord(5, 3))
+		void pause_game()
 		{
 			_pause.store(true);
-			sys::cls();
-			sys::cursorPos(textPos);
-			std::cout << Color::f_cyan << _pause_msg << Color::reset;
 		}
 
 		/**
 		 * unpause_game()
-		 * @brief Disables the pause flag and clears the screen
+		 * @brief Disables the pause flag. Only the simulation thread calls this, the display thread clears the pause screen when it draws the next frame.
 		 */
 		void unpause_game()
 		{
-			sys::cls();
 			_pause.store(false);
 		}
+
+		/**
+		 * show_pause_screen(Coord)
+		 * @brief Clears the screen, and prints the pause message to a given pos. Only the display thread calls this, so all console output comes from one thread.
+		 * @param textPos	- Location in the screen buffer to display the pause message
+		 */
+		void show_pause_screen(const Coord textPos = Coord(5, 3)) const
+		{
+			sys::cls();
+			sys::cursorPos(textPos);
+			std::cout << Color::f_cyan << _pause_msg << Color::reset << std::flush;
+		}
 	};
 }
@@ -0,0 +1,39 @@
+/**
+ * @file span.h
+ * @author radj307
+ * @brief Contains the Span struct, used to describe areas of a cell as a list of horizontal runs of tiles.
+ */
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#include "Coord.h"
+
+/**
+ * @struct Span
+ * @brief A horizontal run of tiles in a single row of a cell.
+ */
+struct Span final {
+	long _y;	///< @brief Y-axis (vertical) index of the row.
+	long _x0;	///< @brief X-axis (horizontal) index of the first tile.
+	long _x1;	///< @brief X-axis (horizontal) index of the last tile (inclusive).
+};
+/**
+ * @brief A list of spans sorted by row, then by first tile. Spans in the same row never overlap.
+ */
+using SpanList = std::vector<Span>;
+
+/**
+ * spanListContains(SpanList&, long, long)
+ * @brief Checks if a given position is covered by a span list, using a binary search.
+ * @param spans		- Target span list.
+ * @param x			- X-axis (horizontal) index.
+ * @param y			- Y-axis (vertical) index.
+ * @returns bool
+ */
+[[nodiscard]] inline bool spanListContains( const SpanList& spans, const long x, const long y )
+{
+	// find the first span that is not entirely before the given position
+	const auto it{ std::lower_bound( spans.begin(), spans.end(), Coord{ x, y }, []( const Span& span, const Coord& pos ) { return span._y < pos._y || ( span._y == pos._y && span._x1 < pos._x ); } ) };
+	return it != spans.end() && it->_y == y && it->_x0 <= x;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file spatialhash.h
+ * @author radj307
+ * @brief Contains the SpatialHash class, a uniform grid of buckets used for range & nearest-neighbour queries on actors.
+ */
+#pragma once
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "actor.h"
+
+/**
+ * @class SpatialHash
+ * @brief Divides a cell into square buckets, each holding a separate list of actor handles for every faction. \n
+ * The bucket size should be roughly the size of an actor's vision range, so that a range query only has to visit a few buckets. \n
+ * The hash does not own anything, the Gamespace is responsible for keeping it in sync when actors spawn, move, or are removed.
+ */
+class SpatialHash final {
+	static constexpr size_t FACTION_COUNT{ static_cast<size_t>(FACTION::NONE) + 1u };
+	using Bucket = std::array<std::vector<ActorBase*>, FACTION_COUNT>;
+public:
+	using Ranking = std::vector<std::pair<long, ActorBase*>>; ///< @brief Scratch buffer type used by nearest(), holds (squared distance, actor) pairs.
+private:
+
+	long _bucket_size;				///< @brief The width & height of each bucket, in tiles.
+	Coord _count;					///< @brief The number of buckets on each axis.
+	std::vector<Bucket> _buckets;	///< @brief Buckets, stored in row-major order.
+	Ranking _scratch; ///< @brief Scratch buffer used by nearest().
+
+	/**
+	 * bucket(Coord&)
+	 * @brief Returns the bucket that contains a given position. Positions outside the grid are clamped to the nearest edge bucket.
+	 * @param pos		- Target position
+	 * @returns Bucket&
+	 */
+	Bucket& bucket( const Coord& pos ) noexcept
+	{
+		auto bx{ pos._x / _bucket_size }, by{ pos._y / _bucket_size };
+		bx = bx < 0 ? 0 : bx >= _count._x ? _count._x - 1 : bx;
+		by = by < 0 ? 0 : by >= _count._y ? _count._y - 1 : by;
+		return _buckets[static_cast<size_t>(by * _count._x + bx)];
+	}
+
+	/**
+	 * forEachInRange(Coord&, int, FactionMask, Func&&)
+	 * @brief Calls a function for each actor within a circular radius of a point, using the same inclusion test as checkDistance::get().
+	 * @tparam Func		- Function type, with the signature void(ActorBase*, long squaredDistance)
+	 * @param center	- The center-point
+	 * @param radius	- The radius of the circle
+	 * @param mask		- Only actors whose faction is included in this mask are visited.
+	 * @param func		- The function to call
+	 */
+	template<typename Func>
+	void forEachInRange( const Coord& center, const int radius, const FactionMask mask, Func&& func ) const
+	{
+		if ( radius < 0 )
+			return;
+		const auto clampX{ [this]( const long b ) { return b < 0 ? 0 : b >= _count._x ? _count._x - 1 : b; } };
+		const auto clampY{ [this]( const long b ) { return b < 0 ? 0 : b >= _count._y ? _count._y - 1 : b; } };
+		const auto minX{ clampX( ( center._x - radius ) / _bucket_size ) }, maxX{ clampX( ( center._x + radius ) / _bucket_size ) };
+		const auto minY{ clampY( ( center._y - radius ) / _bucket_size ) }, maxY{ clampY( ( center._y + radius ) / _bucket_size ) };
+		const auto r2{ static_cast<long>(radius) * radius };
+		for ( auto by{ minY }; by <= maxY; ++by )
+			for ( auto bx{ minX }; bx <= maxX; ++bx )
+				for ( size_t faction{ 0u }; faction < FACTION_COUNT; ++faction )
+					if ( ( mask & 1u << faction ) != 0u )
+						for ( auto* const actor : _buckets[static_cast<size_t>(by * _count._x + bx)][faction] ) {
+							const auto dx{ actor->pos()._x - center._x }, dy{ actor->pos()._y - center._y };
+							if ( const auto d2{ dx * dx + dy * dy }; d2 <= r2 )
+								func( actor, d2 );
+						}
+	}
+
+public:
+	/**
+	 * SpatialHash(Coord&, long)
+	 * @brief Create an empty spatial hash covering an area of the given size.
+	 * @param size			- The size of the covered area, this should be the _max member of the attached Cell.
+	 * @param bucketSize	- The width & height of each bucket, in tiles. Values less than 1 are treated as 1.
+	 */
+	SpatialHash( const Coord& size, const long bucketSize ) : _bucket_size( bucketSize > 0 ? bucketSize : 1 ), _count( ( size._x > 0 ? size._x : 1 ) / _bucket_size + 1, ( size._y > 0 ? size._y : 1 ) / _bucket_size + 1 ), _buckets( static_cast<size_t>(_count._x * _count._y) ) {}
+
+	/**
+	 * clear()
+	 * @brief Removes all actors from the hash.
+	 */
+	void clear() noexcept
+	{
+		for ( auto& b : _buckets )
+			for ( auto& list : b )
+				list.clear();
+	}
+
+	/**
+	 * insert(ActorBase*)
+	 * @brief Adds an actor to the bucket containing its current position.
+	 * @param actor	- Target actor
+	 */
+	void insert( ActorBase* actor ) { bucket( actor->pos() )[static_cast<size_t>(actor->faction())].push_back( actor ); }
+
+	/**
+	 * remove(ActorBase*, Coord&)
+	 * @brief Removes an actor from the bucket containing a given position.
+	 * @param actor	- Target actor
+	 * @param pos	- The position the actor was at when it was inserted, or last moved to.
+	 */
+	void remove( const ActorBase* actor, const Coord& pos ) noexcept
+	{
+		auto& list{ bucket( pos )[static_cast<size_t>(actor->faction())] };
+		if ( const auto it{ std::find( list.begin(), list.end(), actor ) }; it != list.end() ) {
+			*it = list.back(); // swap & pop, order within a bucket doesn't matter
+			list.pop_back();
+		}
+	}
+
+	/**
+	 * move(ActorBase*, Coord&, Coord&)
+	 * @brief Updates an actor's bucket after it moved. Does nothing if the actor stayed in the same bucket.
+	 * @param actor	- Target actor
+	 * @param from	- The actor's previous position.
+	 * @param to	- The actor's current position.
+	 */
+	void move( ActorBase* actor, const Coord& from, const Coord& to )
+	{
+		if ( &bucket( from ) != &bucket( to ) ) {
+			remove( actor, from );
+			bucket( to )[static_cast<size_t>(actor->faction())].push_back( actor );
+		}
+	}
+
+	/**
+	 * within(Coord&, int, FactionMask, vector<T*>&)
+	 * @brief Retrieves all actors within a circular radius of a point.
+	 * @tparam T		- Element type of the output buffer, this must be ActorBase or a type derived from it that matches every faction in mask.
+	 * @param center	- The center-point
+	 * @param radius	- The radius of the circle
+	 * @param mask		- Only actors whose faction is included in this mask are returned.
+	 * @param out		- Receives the actors, in no particular order. This is cleared first.
+	 */
+	template<typename T>
+	void within( const Coord& center, const int radius, const FactionMask mask, std::vector<T*>& out )
+	{
+		out.clear();
+		forEachInRange( center, radius, mask, [&out]( ActorBase* actor, long ) { out.push_back( static_cast<T*>(actor) ); } );
+	}
+
+	/**
+	 * nearest(Coord&, int, size_t, FactionMask, vector<ActorBase*>&, ActorBase*)
+	 * @brief Retrieves the k actors closest to a point, within a circular radius.
+	 * @param center	- The center-point
+	 * @param radius	- The maximum distance from the center-point
+	 * @param k			- The maximum number of actors to return.
+	 * @param mask		- Only actors whose faction is included in this mask are returned.
+	 * @param out		- Receives the actors, sorted from closest to furthest. This is cleared first.
+	 * @param exclude	- (Default: nullptr) An actor to skip, such as the actor performing the query.
+	 */
+	void nearest( const Coord& center, const int radius, const size_t k, const FactionMask mask, std::vector<ActorBase*>& out, const ActorBase* exclude = nullptr ) { nearest( center, radius, k, mask, out, exclude, _scratch ); }
+
+	/**
+	 * forEachObserver(Coord&, int, FactionMask, Func&&, int)
+	 * @brief Calls a function for each actor whose own vision range covers a given point. \n
+	 * This is used to notify actors of events, such as another actor moving to or from a tile they can see.
+	 * @tparam Func		- Function type, with the signature void(ActorBase*)
+	 * @param pos		- The position of the event.
+	 * @param maxVis	- The largest vision range of any actor, only actors within this distance are checked.
+	 * @param mask		- Only actors whose faction is included in this mask are notified.
+	 * @param func		- The function to call
+	 * @param margin	- (Default: 0) A distance added to each actor's vision range, to also notify actors that are slightly too far away to see the point.
+	 */
+	template<typename Func>
+	void forEachObserver( const Coord& pos, const int maxVis, const FactionMask mask, Func&& func, const int margin = 0 ) const
+	{
+		forEachInRange( pos, maxVis + margin, mask, [&func, margin]( ActorBase* actor, const long d2 ) {
+			if ( const auto range{ static_cast<long>(actor->getVis()) + margin }; d2 <= range * range )
+				func( actor );
+		} );
+	}
+
+	/**
+	 * nearest(Coord&, int, size_t, FactionMask, vector<ActorBase*>&, ActorBase*, Ranking&)
+	 * @brief Retrieves the k actors closest to a point, within a circular radius, using a caller-provided scratch buffer. \n
+	 * This doesn't modify the hash, so it can be called from several threads at once as long as each thread uses its own buffers.
+	 * @param center	- The center-point
+	 * @param radius	- The maximum distance from the center-point
+	 * @param k			- The maximum number of actors to return.
+	 * @param mask		- Only actors whose faction is included in this mask are returned.
+	 * @param out		- Receives the actors, sorted from closest to furthest. This is cleared first.
+	 * @param exclude	- An actor to skip, such as the actor performing the query.
+	 * @param scratch	- Scratch buffer used to rank the actors.
+	 */
+	void nearest( const Coord& center, const int radius, const size_t k, const FactionMask mask, std::vector<ActorBase*>& out, const ActorBase* exclude, Ranking& scratch ) const
+	{
+		out.clear();
+		scratch.clear();
+		forEachInRange( center, radius, mask, [&scratch, exclude]( ActorBase* actor, const long d2 ) {
+			if ( actor != exclude )
+				scratch.emplace_back( d2, actor );
+		} );
+		const auto count{ k < scratch.size() ? k : scratch.size() };
+		const auto byDistance{ []( const std::pair<long, ActorBase*>& a, const std::pair<long, ActorBase*>& b ) { return a.first < b.first; } };
+		std::partial_sort( scratch.begin(), scratch.begin() + static_cast<std::ptrdiff_t>(count), scratch.end(), byDistance );
+		for ( size_t i{ 0u }; i < count; ++i )
+			out.push_back( scratch[i].second );
+	}
+};
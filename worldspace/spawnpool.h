@@ -0,0 +1,105 @@
+/**
+ * @file spawnpool.h
+ * @author radj307
+ * @brief Contains the SpawnPool class, an indexed set of the tiles that entities can currently spawn on.
+ */
+#pragma once
+#include <utility>
+#include <vector>
+
+#include "Coord.h"
+
+/**
+ * @class SpawnPool
+ * @brief Indexed set of tile positions, with constant-time insertion, removal, & random access. \n
+ * Positions are stored densely in a vector, and each tile stores its index in that vector so it can be removed by swapping it with the last element.
+ */
+class SpawnPool final {
+	Coord _size;				///< @brief The size of the covered area, this should match the size of the attached Cell.
+	std::vector<Coord> _tiles;	///< @brief Dense list of the positions in the set, in no particular order.
+	std::vector<long> _slot;	///< @brief Index of each tile in _tiles, or -1 if the tile isn't in the set. Stored in row-major order.
+
+	/**
+	 * index(Coord&)
+	 * @brief Returns the row-major index of a given position. Does not check boundaries.
+	 * @param pos	- Target position
+	 * @returns size_t
+	 */
+	[[nodiscard]] size_t index( const Coord& pos ) const noexcept { return static_cast<size_t>(pos._y) * static_cast<size_t>(_size._x) + static_cast<size_t>(pos._x); }
+
+public:
+	const checkBounds isValidPos; ///< @brief Functor that can be used to check if a point is within the boundaries of the pool.
+
+	/**
+	 * SpawnPool(Coord&)
+	 * @brief Create an empty spawn pool covering an area of the given size.
+	 * @param size	- The size of the covered area, this should be the _max member of the attached Cell.
+	 */
+	explicit SpawnPool( const Coord& size ) : _size( size ), _slot( static_cast<size_t>(size._x > 0 ? size._x : 0) * static_cast<size_t>(size._y > 0 ? size._y : 0), -1 ), isValidPos( _size ) {}
+
+	/**
+	 * contains(Coord&)
+	 * @brief Checks if a given position is in the set.
+	 * @param pos		- Target position
+	 * @returns bool
+	 */
+	[[nodiscard]] bool contains( const Coord& pos ) const noexcept { return isValidPos( pos ) && _slot[index( pos )] != -1; }
+
+	/**
+	 * insert(Coord&)
+	 * @brief Adds a position to the set, if it isn't already in it.
+	 * @param pos		- Target position
+	 */
+	void insert( const Coord& pos )
+	{
+		if ( isValidPos( pos ) && _slot[index( pos )] == -1 ) {
+			_slot[index( pos )] = static_cast<long>(_tiles.size());
+			_tiles.push_back( pos );
+		}
+	}
+
+	/**
+	 * erase(Coord&)
+	 * @brief Removes a position from the set, if it is in it.
+	 * @param pos		- Target position
+	 */
+	void erase( const Coord& pos ) noexcept
+	{
+		if ( contains( pos ) ) {
+			const auto i{ static_cast<size_t>(_slot[index( pos )]) };
+			swap( i, _tiles.size() - 1u ); // move to the end, then pop
+			_slot[index( pos )] = -1;
+			_tiles.pop_back();
+		}
+	}
+
+	/**
+	 * swap(size_t, size_t)
+	 * @brief Swaps the positions stored at two indexes of the set. Does not check boundaries.
+	 * @param a		- Index of the first element
+	 * @param b		- Index of the second element
+	 */
+	void swap( const size_t a, const size_t b ) noexcept
+	{
+		if ( a != b ) {
+			std::swap( _tiles[a], _tiles[b] );
+			_slot[index( _tiles[a] )] = static_cast<long>(a);
+			_slot[index( _tiles[b] )] = static_cast<long>(b);
+		}
+	}
+
+	/**
+	 * at(size_t)
+	 * @brief Returns the position stored at a given index of the set. Does not check boundaries.
+	 * @param i			- Element index, must be less than size().
+	 * @returns Coord&
+	 */
+	[[nodiscard]] const Coord& at( const size_t i ) const noexcept { return _tiles[i]; }
+
+	/**
+	 * size()
+	 * @brief Returns the number of positions in the set.
+	 * @returns size_t
+	 */
+	[[nodiscard]] size_t size() const noexcept { return _tiles.size(); }
+};
@@ -0,0 +1,236 @@
+/**
+ * @file terminal.h
+ * @author radj307
+ * @brief Contains the Terminal class, an output buffer that encodes console output as ANSI/VT escape sequences & writes it in a single system call.
+ */
+#pragma once
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+/**
+ * @class Terminal
+ * @brief Collects everything drawn during a frame into one preallocated byte buffer, using VT escape sequences for cursor movement & colors, and writes it to stdout all at once. \n
+ * On Linux the buffer is written with write(2), on Windows it is written with WriteFile after enabling virtual terminal processing, so a frame costs one system call regardless of how many tiles changed. \n
+ * Colors are given as console attributes, the same values used by sys::colorSet(), and are converted to SGR sequences. \n
+ * The cursor position & current color are tracked while encoding, so moving to where the cursor already is, or setting the color that is already active, doesn't emit anything. \n
+ * Both are forgotten after each flush, as other output may be printed between frames.
+ */
+class Terminal final {
+	std::string _buffer;	///< @brief The bytes waiting to be written.
+	long _cursor_x{ -1 },	///< @brief The column the cursor is at, or -1 if unknown.
+		 _cursor_y{ -1 };	///< @brief The row the cursor is at, or -1 if unknown.
+	int _color{ -1 };		///< @brief The active color attribute, or -1 if unknown.
+
+	/**
+	 * append(long)
+	 * @brief Appends the decimal representation of a number to the buffer.
+	 * @param value	- The number to append.
+	 */
+	void append(const long value)
+	{
+		char digits[24];
+		const auto [end, ec] { std::to_chars(digits, digits + sizeof(digits), value) };
+		_buffer.append(digits, end);
+	}
+
+	/**
+	 * to_ansi(unsigned short)
+	 * @brief Converts the 3 color bits of a console attribute (blue, green, red) to an ANSI color index (red, green, blue).
+	 * @param bits		- The color bits, without the intensity bit.
+	 * @returns long
+	 */
+	[[nodiscard]] static constexpr long to_ansi(const unsigned short bits) noexcept { return static_cast<long>(( ( bits & 1u ) << 2u ) | ( bits & 2u ) | ( ( bits & 4u ) >> 2u )); }
+
+public:
+	static constexpr size_t BYTES_PER_CELL{ 32u }; ///< @brief The maximum number of bytes needed to draw one tile: a cursor move, a color, the glyph, and a color reset.
+	static constexpr unsigned short DEFAULT_COLOR{ 0x07u }; ///< @brief Light grey on black, the default console color. Setting this color resets the terminal's colors.
+
+	/**
+	 * hasBackground(unsigned short)
+	 * @brief Checks if a color attribute sets a background color, in which case blank space written with it is visible.
+	 * @param attribute	- A console color attribute.
+	 * @returns bool
+	 */
+	[[nodiscard]] static constexpr bool hasBackground(const unsigned short attribute) noexcept { return ( attribute & 0xF0u ) != 0u; }
+
+	/**
+	 * Terminal(size_t)
+	 * @brief Create a terminal output buffer, and enable VT sequence processing on consoles that need it.
+	 * @param capacity	- The number of bytes to preallocate, this should be enough for the largest frame so the buffer never reallocates.
+	 */
+	explicit Terminal(const size_t capacity)
+	{
+		_buffer.reserve(capacity);
+	#ifdef _WIN32
+		if ( auto* const out{ GetStdHandle(STD_OUTPUT_HANDLE) }; out != INVALID_HANDLE_VALUE ) {
+			DWORD mode{ 0 };
+			if ( GetConsoleMode(out, &mode) )
+				SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+		}
+	#endif
+	}
+
+	/**
+	 * size()
+	 * @brief Returns the number of bytes waiting to be written.
+	 * @returns size_t
+	 */
+	[[nodiscard]] size_t size() const noexcept { return _buffer.size(); }
+
+	/**
+	 * moveTo(long, long)
+	 * @brief Moves the cursor to a position in the screen buffer, using the same 0-based coordinates as sys::cursorPos(). \n
+	 * Nothing is emitted if the cursor is already there, and moves to the right within the same row use the shorter cursor-forward sequence.
+	 * @param x	- Column
+	 * @param y	- Row
+	 */
+	void moveTo(const long x, const long y)
+	{
+		if ( x == _cursor_x && y == _cursor_y )
+			return;
+		_buffer.append("\x1b[");
+		if ( y == _cursor_y && x > _cursor_x && _cursor_x >= 0 ) {
+			if ( x - _cursor_x > 1 )
+				append(x - _cursor_x);
+			_buffer.push_back('C');
+		}
+		else {
+			append(y + 1);
+			_buffer.push_back(';');
+			append(x + 1);
+			_buffer.push_back('H');
+		}
+		_cursor_x = x;
+		_cursor_y = y;
+	}
+
+	/**
+	 * color(unsigned short)
+	 * @brief Sets the color of the following output. Nothing is emitted if this color is already active. \n
+	 * When the active color is known, only the foreground or background that changed is emitted, otherwise both are set after a full reset.
+	 * @param attribute	- A console color attribute, such as a member of the Color enum.
+	 */
+	void color(const unsigned short attribute)
+	{
+		if ( attribute == _color )
+			return;
+		const auto previous{ _color };
+		_color = attribute;
+		if ( attribute == DEFAULT_COLOR ) {
+			_buffer.append("\x1b[0m");
+			return;
+		}
+		const auto fg{ static_cast<unsigned short>(attribute & 0x0Fu) }, bg{ static_cast<unsigned short>(attribute >> 4u & 0x0Fu) };
+		const auto known{ previous >= 0 };
+		const auto setFg{ !known || fg != ( previous & 0x0F ) }, setBg{ !known || bg != ( previous >> 4 & 0x0F ) };
+		if ( !setFg && !setBg ) // only bits that aren't shown changed
+			return;
+		_buffer.append(known ? "\x1b[" : "\x1b[0;");
+		// light grey on black is the default console color, use the terminal's own defaults for it
+		if ( setFg ) {
+			if ( fg == 7u )
+				_buffer.append("39");
+			else append(( fg & 8u ? 90 : 30 ) + to_ansi(fg & 7u));
+			if ( setBg )
+				_buffer.push_back(';');
+		}
+		if ( setBg ) {
+			if ( bg == 0u )
+				_buffer.append("49");
+			else append(( bg & 8u ? 100 : 40 ) + to_ansi(bg & 7u));
+		}
+		_buffer.push_back('m');
+	}
+
+	/**
+	 * reset()
+	 * @brief Resets the color of the following output to the default.
+	 */
+	void reset() { color(DEFAULT_COLOR); }
+
+	/**
+	 * clear()
+	 * @brief Clears the entire screen.
+	 */
+	void clear()
+	{
+		_buffer.append("\x1b[0m\x1b[2J");
+		_color = DEFAULT_COLOR;
+	}
+
+	/**
+	 * put(char)
+	 * @brief Writes a single character at the cursor position.
+	 * @param ch	- The character to write.
+	 */
+	void put(const char ch)
+	{
+		_buffer.push_back(ch);
+		if ( _cursor_x >= 0 )
+			++_cursor_x;
+	}
+
+	/**
+	 * put(string_view)
+	 * @brief Writes a string at the cursor position.
+	 * @param str	- The string to write.
+	 */
+	void put(const std::string_view str)
+	{
+		_buffer.append(str);
+		if ( _cursor_x >= 0 )
+			_cursor_x += static_cast<long>(str.size());
+	}
+
+	/**
+	 * flush()
+	 * @brief Writes the buffer to stdout with a single system call, and empties it. The preallocated capacity is kept.
+	 * @returns bool	- ( true = Everything was written ) ( false = The write failed, the remaining bytes were discarded )
+	 */
+	bool flush()
+	{
+		_cursor_x = _cursor_y = -1;
+		_color = -1;
+		if ( _buffer.empty() )
+			return true;
+		std::fflush(stdout); // anything printed through stdio must appear before this frame
+		auto* data{ _buffer.data() };
+		auto remaining{ _buffer.size() };
+		auto success{ true };
+	#ifdef _WIN32
+		auto* const out{ GetStdHandle(STD_OUTPUT_HANDLE) };
+		while ( remaining > 0u ) {
+			DWORD written{ 0 };
+			if ( !WriteFile(out, data, static_cast<DWORD>(remaining), &written, nullptr) || written == 0 ) {
+				success = false;
+				break;
+			}
+			data += written;
+			remaining -= written;
+		}
+	#else
+		// write(2) only returns early when interrupted or when the terminal's buffer is full
+		while ( remaining > 0u ) {
+			const auto written{ ::write(STDOUT_FILENO, data, remaining) };
+			if ( written < 0 && errno == EINTR )
+				continue;
+			if ( written <= 0 ) {
+				success = false;
+				break;
+			}
+			data += written;
+			remaining -= static_cast<size_t>(written);
+		}
+	#endif
+		_buffer.clear();
+		return success;
+	}
+};
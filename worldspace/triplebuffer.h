@@ -0,0 +1,79 @@
+/**
+ * @file triplebuffer.h
+ * @author radj307
+ * @brief Contains the TripleBuffer class, a lock-free single-producer single-consumer exchange that always hands the consumer the latest value.
+ */
+#pragma once
+#include <array>
+#include <atomic>
+
+/**
+ * @class TripleBuffer
+ * @brief Passes values from one writer thread to one reader thread without locking, and without either thread ever waiting for the other. \n
+ * There are three slots: one owned by the writer, one owned by the reader, and one shared slot in between. \n
+ * The writer fills its slot & exchanges it with the shared slot, and the reader exchanges its slot with the shared slot when a new value was published. \n
+ * Values the reader didn't take before the next one was published are skipped, so a slow reader only ever sees the latest value.
+ * @tparam T	- The value type. Slots are reused, so the writer should overwrite every member of its slot before publishing it.
+ */
+template<typename T>
+class TripleBuffer final {
+	static constexpr unsigned FRESH{ 4u }; ///< @brief Set in _shared when the shared slot holds a value the reader hasn't taken yet.
+
+public:
+	static constexpr unsigned SLOTS{ 3u }; ///< @brief The number of slots.
+
+private:
+	std::array<T, SLOTS> _slots;			///< @brief The three slots.
+	std::atomic<unsigned> _shared{ 1u };	///< @brief The index of the shared slot, combined with the FRESH flag.
+	unsigned _write{ 0u },					///< @brief The index of the writer's slot, only accessed by the writer.
+			 _read{ 2u };					///< @brief The index of the reader's slot, only accessed by the reader.
+
+public:
+	/**
+	 * TripleBuffer(T&)
+	 * @brief Create a triple buffer where every slot is a copy of a given value.
+	 * @param init	- The initial value of each slot.
+	 */
+	explicit TripleBuffer(const T& init) : _slots{ init, init, init } {}
+
+	/**
+	 * writeSlot()
+	 * @brief Returns the writer's slot. Only call this from the writer thread.
+	 * @returns T&
+	 */
+	[[nodiscard]] T& writeSlot() noexcept { return _slots[_write]; }
+
+	/**
+	 * writeIndex()
+	 * @brief Returns the index of the writer's slot, between 0 & SLOTS - 1. Only call this from the writer thread. \n
+	 * Each slot keeps its index, so the writer can use it to keep its own data about the contents of each slot.
+	 * @returns unsigned
+	 */
+	[[nodiscard]] unsigned writeIndex() const noexcept { return _write; }
+
+	/**
+	 * publish()
+	 * @brief Makes the value in the writer's slot available to the reader, and gives the writer a new slot. Only call this from the writer thread.
+	 */
+	void publish() noexcept { _write = _shared.exchange(_write | FRESH, std::memory_order_acq_rel) & ~FRESH; }
+
+	/**
+	 * acquire()
+	 * @brief Takes the latest published value if there is one the reader doesn't have yet. Only call this from the reader thread.
+	 * @returns bool	- ( true = readSlot() now holds a new value ) ( false = Nothing was published since the last call, readSlot() is unchanged )
+	 */
+	bool acquire() noexcept
+	{
+		if ( ( _shared.load(std::memory_order_relaxed) & FRESH ) == 0u )
+			return false;
+		_read = _shared.exchange(_read, std::memory_order_acq_rel) & ~FRESH;
+		return true;
+	}
+
+	/**
+	 * readSlot()
+	 * @brief Returns the reader's slot, which holds the value taken by the last successful call to acquire(). Only call this from the reader thread.
+	 * @returns T&
+	 */
+	[[nodiscard]] T& readSlot() noexcept { return _slots[_read]; }
+};